@@ -17,6 +17,8 @@
 #include "Defs.h"
 #include "sr_router.h"
 #include "IPDatagramBuffer.h"
+#include "Bridge.h"
+#include "watchdog.h"
 
 /**********************************************************************/
 /*For debugging purposes***********************************************/
@@ -118,6 +120,8 @@ static void deleteArpRequestTracker(const uint32_t ip, struct sr_if* iface);
 
 void handleArpPacket(struct sr_instance* sr, uint8_t * ethPacket, struct sr_if* iface){
 
+	WATCHDOG_STAGE(sr, WD_STAGE_ARP);
+
 	struct sr_arphdr* arphdr = (struct sr_arphdr*)(ethPacket + sizeof(struct sr_ethernet_hdr));
 
 	assert(arphdr);
@@ -151,7 +155,11 @@ void handleArpPacket(struct sr_instance* sr, uint8_t * ethPacket, struct sr_if*
 
 	int updated_arp_entry = updateArpEntry(iface->ip_eth_arp_tbl, arphdr->ar_sip, arphdr->ar_sha);
 
-	if(arphdr->ar_tip != iface->ip){
+	//the bridge virtual interface answers for the ip addr
+	//of every bridge port, with that port's mac addr
+	struct sr_if* target_iface = isBridgeVirtualInterface(sr, iface) ? bridgePortWithIP(sr, arphdr->ar_tip) : iface;
+
+	if(!target_iface || (arphdr->ar_tip != target_iface->ip)){
 		//this arp packet is not targeted for the ip bounded to the interface
 		//nothing more to do with the arp packet
 		return;
@@ -167,7 +175,7 @@ void handleArpPacket(struct sr_instance* sr, uint8_t * ethPacket, struct sr_if*
 	}
 
 	if(ntohs(arphdr->ar_op) == ARP_REQUEST){
-		setupArpResponse(arphdr, iface);
+		setupArpResponse(arphdr, target_iface);
 		sendEthFrameContainingArpMsg(sr, arphdr->ar_tha, ethPacket, iface, sizeof(struct sr_arphdr));
 	}
 	else if(ntohs(arphdr->ar_op) == ARP_REPLY){
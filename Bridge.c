@@ -0,0 +1,426 @@
+/*
+ * Bridge.c
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+#include "Bridge.h"
+#include "Ethernet.h"
+#include "sr_if.h"
+#include "sr_protocol.h"
+#include "watchdog.h"
+
+/*Find the slot the mac addr hashes to
+ * @return the index of the slot
+ */
+static unsigned int hashMAC(const uint8_t* mac);
+
+/*Find the slot holding the mac addr
+ * @return the slot, or NULL if the mac addr hasn't been learned
+ */
+static struct mac_tbl_entry* findMacEntry(struct bridge* bridge, const uint8_t* mac);
+
+/*Record that the mac addr was seen on the port, adding it to
+ * the mac learning table if it isn't there yet
+ */
+static void learnMAC(struct bridge* bridge, const uint8_t* mac, struct sr_if* port);
+
+/*Empty a slot of the mac learning table, moving back the entries
+ * probed past it so no lookup stops early at the hole
+ * @param bridge the bridge
+ * @param slot the index of the slot to empty
+ */
+static void deleteMacEntry(struct bridge* bridge, unsigned int slot);
+
+/*Checks to see if the mac entry has aged out
+ * @return 1 if it has, 0 otherwise
+ */
+static int isMacEntryExpired(struct mac_tbl_entry* mac_entry, time_t now);
+
+/*Send the frame out every bridge port but the one passed in
+ * @param sr the router instance
+ * @param eth_frame the eth frame
+ * @param len the size of the eth frame in bytes
+ * @param in_port the port the frame came from, NULL if it
+ * 		came from the bridge virtual interface
+ */
+static void floodFrame(struct sr_instance* sr, uint8_t* eth_frame, unsigned int len, struct sr_if* in_port);
+
+/*Checks to see if the mac addr is a group (broadcast or
+ * multicast) addr
+ * @return 1 if it is, 0 otherwise
+ */
+static int isGroupMAC(const uint8_t* mac);
+
+
+void bridgeConfigure(struct sr_instance* sr, const char* iface_names){
+
+	assert(sr);
+	assert(iface_names);
+
+	if(!sr->bridge){
+		sr->bridge = (struct bridge*) malloc(sizeof(struct bridge));
+		assert(sr->bridge);
+		bzero(sr->bridge, sizeof(struct bridge));
+	}
+
+	char* names = strdup(iface_names);
+	assert(names);
+
+	//keep the ports in the order given, the first one lends
+	//its addrs to the bridge virtual interface
+	struct bridge_port** last_port_ptr = &(sr->bridge->port_list);
+	while(*last_port_ptr){
+		last_port_ptr = &((*last_port_ptr)->next);
+	}
+
+	char* name = strtok(names, ",");
+	while(name){
+		struct bridge_port* port = (struct bridge_port*) malloc(sizeof(struct bridge_port));
+		assert(port);
+		strncpy(port->name, name, sr_IFACE_NAMELEN);
+		port->iface = NULL;
+		port->next = NULL;
+		*last_port_ptr = port;
+		last_port_ptr = &(port->next);
+
+		name = strtok(NULL, ",");
+	}
+
+	free(names);
+}
+
+void bridgeStart(struct sr_instance* sr){
+
+	assert(sr);
+
+	struct bridge* bridge = sr->bridge;
+	if(!bridge || bridge->bvi){
+		return;
+	}
+
+	//drop the ports named that don't exist, so every port
+	//left has an interface
+	struct bridge_port** port_ptr = &(bridge->port_list);
+	while(*port_ptr){
+		struct bridge_port* port = *port_ptr;
+		port->iface = sr_get_interface(sr, port->name);
+		if(port->iface){
+			port_ptr = &(port->next);
+		}
+		else{
+			fprintf(stderr, "bridge: no interface %s, ignoring it\n", port->name);
+			*port_ptr = port->next;
+			free(port);
+		}
+	}
+
+	if(!bridge->port_list){
+		return;
+	}
+
+	struct sr_if* first_port = bridge->port_list->iface;
+
+	sr_add_interface(sr, BRIDGE_VIRTUAL_IFACE_NAME);
+	sr_set_ether_addr(sr, first_port->addr);
+	sr_set_ether_ip(sr, first_port->ip);
+	sr_set_ether_mask(sr, first_port->mask);
+
+	struct sr_if* bvi = sr_get_interface(sr, BRIDGE_VIRTUAL_IFACE_NAME);
+	assert(bvi);
+	bvi->speed = first_port->speed;
+	bvi->ip_eth_arp_tbl = NULL;
+	bvi->arp_request_tracker_list = NULL;
+	bvi->sr = sr;
+	bridge->bvi = bvi;
+
+	time(&(bridge->last_sample_time));
+
+	printf("bridge: %s bridges", bvi->name);
+	for(struct bridge_port* port = bridge->port_list; port; port = port->next){
+		printf(" %s", port->name);
+	}
+	printf("\n");
+}
+
+int isBridgePort(struct sr_instance* sr, struct sr_if* iface){
+
+	if(!iface || !sr->bridge || !sr->bridge->bvi){
+		return FALSE;
+	}
+
+	struct bridge_port* port = sr->bridge->port_list;
+	while(port){
+		if(port->iface == iface){
+			return TRUE;
+		}
+		port = port->next;
+	}
+
+	return FALSE;
+}
+
+int isBridgeVirtualInterface(struct sr_instance* sr, struct sr_if* iface){
+	return sr->bridge && iface && (sr->bridge->bvi == iface);
+}
+
+struct sr_if* bridgeRoutingInterface(struct sr_instance* sr, struct sr_if* iface){
+	return isBridgePort(sr, iface) ? sr->bridge->bvi : iface;
+}
+
+struct sr_if* bridgePortWithIP(struct sr_instance* sr, uint32_t ip){
+
+	if(!sr->bridge || !sr->bridge->bvi){
+		return NULL;
+	}
+
+	struct bridge_port* port = sr->bridge->port_list;
+	while(port){
+		if(port->iface->ip == ip){
+			return port->iface;
+		}
+		port = port->next;
+	}
+
+	return NULL;
+}
+
+int isBridgeMAC(struct sr_instance* sr, const uint8_t* mac){
+
+	if(!sr->bridge || !sr->bridge->bvi){
+		return FALSE;
+	}
+
+	struct bridge_port* port = sr->bridge->port_list;
+	while(port){
+		if(MACcmp(port->iface->addr, mac)){
+			return TRUE;
+		}
+		port = port->next;
+	}
+
+	return FALSE;
+}
+
+struct sr_if* bridgeHandleFrame(struct sr_instance* sr, uint8_t* eth_frame, unsigned int len, struct sr_if* port){
+
+	int prev_stage = WATCHDOG_ENTER_STAGE(sr, WD_STAGE_BRIDGE);
+
+	struct bridge* bridge = sr->bridge;
+	struct sr_ethernet_hdr* eth_hdr = (struct sr_ethernet_hdr*)eth_frame;
+
+	if(!isGroupMAC(eth_hdr->ether_shost)){
+		learnMAC(bridge, eth_hdr->ether_shost, port);
+	}
+
+	if(isBridgeMAC(sr, eth_hdr->ether_dhost)){
+		//for the routing side only, which owns the addrs of
+		//all the ports whichever port the frame came in on
+		WATCHDOG_LEAVE_STAGE(sr, prev_stage);
+		return bridge->bvi;
+	}
+
+	if(isGroupMAC(eth_hdr->ether_dhost)){
+		//everyone on the bridge gets a copy, the routing side too
+		floodFrame(sr, eth_frame, len, port);
+		WATCHDOG_LEAVE_STAGE(sr, prev_stage);
+		return bridge->bvi;
+	}
+
+	struct mac_tbl_entry* mac_entry = findMacEntry(bridge, eth_hdr->ether_dhost);
+
+	if(!mac_entry){
+		//unknown unicast
+		floodFrame(sr, eth_frame, len, port);
+	}
+	else if(mac_entry->port == port){
+		//destination is on the segment the frame came from
+		bridge->num_frames_filtered++;
+	}
+	else{
+		//known unicast, send the frame on as is
+		sr_send_packet(sr, eth_frame, len, mac_entry->port->name);
+		bridge->num_frames_forwarded++;
+	}
+
+	WATCHDOG_LEAVE_STAGE(sr, prev_stage);
+	return NULL;
+}
+
+void bridgeSendFrame(struct sr_instance* sr, uint8_t* eth_frame, unsigned int len){
+
+	struct bridge* bridge = sr->bridge;
+	struct sr_ethernet_hdr* eth_hdr = (struct sr_ethernet_hdr*)eth_frame;
+
+	struct mac_tbl_entry* mac_entry = NULL;
+	if(!isGroupMAC(eth_hdr->ether_dhost)){
+		mac_entry = findMacEntry(bridge, eth_hdr->ether_dhost);
+	}
+
+	if(mac_entry){
+		sr_send_packet(sr, eth_frame, len, mac_entry->port->name);
+		bridge->num_frames_forwarded++;
+	}
+	else{
+		floodFrame(sr, eth_frame, len, NULL);
+	}
+}
+
+void bridgeHandleTimers(struct sr_instance* sr){
+
+	struct bridge* bridge = sr->bridge;
+	if(!bridge || !bridge->bvi){
+		return;
+	}
+
+	time_t now = time(NULL);
+
+	unsigned int slot = 0;
+	while(slot < BRIDGE_MAC_TBL_SIZE){
+		if(bridge->mac_tbl[slot].in_use && isMacEntryExpired(&(bridge->mac_tbl[slot]), now)){
+			//an entry may have been moved into this slot,
+			//look at it again
+			deleteMacEntry(bridge, slot);
+		}
+		else{
+			slot++;
+		}
+	}
+
+	double elapsed = difftime(now, bridge->last_sample_time);
+	if(elapsed >= BRIDGE_STATS_INTERVAL){
+		long num_flooded = bridge->num_frames_flooded - bridge->num_frames_flooded_last_sample;
+		bridge->flood_rate = num_flooded / elapsed;
+		bridge->num_frames_flooded_last_sample = bridge->num_frames_flooded;
+		bridge->last_sample_time = now;
+
+		if(num_flooded > 0){
+			printBridgeStats(sr);
+		}
+	}
+}
+
+void printBridgeStats(struct sr_instance* sr){
+
+	struct bridge* bridge = sr->bridge;
+	if(!bridge){
+		return;
+	}
+
+	printf("bridge: %d macs learned, %.1f floods/s, %ld forwarded, %ld flooded, %ld filtered\n",
+			bridge->num_mac_entries, bridge->flood_rate, bridge->num_frames_forwarded,
+			bridge->num_frames_flooded, bridge->num_frames_filtered);
+}
+
+static void floodFrame(struct sr_instance* sr, uint8_t* eth_frame, unsigned int len, struct sr_if* in_port){
+
+	struct bridge_port* port = sr->bridge->port_list;
+	while(port){
+		if(port->iface != in_port){
+			sr_send_packet(sr, eth_frame, len, port->name);
+		}
+		port = port->next;
+	}
+
+	sr->bridge->num_frames_flooded++;
+}
+
+static void learnMAC(struct bridge* bridge, const uint8_t* mac, struct sr_if* port){
+
+	unsigned int slot = hashMAC(mac);
+
+	while(bridge->mac_tbl[slot].in_use){
+		if(MACcmp(bridge->mac_tbl[slot].mac_addr, mac)){
+			//already known, the host may have moved
+			bridge->mac_tbl[slot].port = port;
+			time(&(bridge->mac_tbl[slot].last_seen));
+			return;
+		}
+		slot = (slot + 1) & (BRIDGE_MAC_TBL_SIZE - 1);
+	}
+
+	if(bridge->num_mac_entries >= BRIDGE_MAC_TBL_MAX_LOAD){
+		//table full, frames to this mac will be flooded
+		return;
+	}
+
+	struct mac_tbl_entry* mac_entry = &(bridge->mac_tbl[slot]);
+	memcpy(mac_entry->mac_addr, mac, ETHER_ADDR_LEN);
+	mac_entry->in_use = TRUE;
+	mac_entry->port = port;
+	time(&(mac_entry->last_seen));
+
+	bridge->num_mac_entries++;
+}
+
+static struct mac_tbl_entry* findMacEntry(struct bridge* bridge, const uint8_t* mac){
+
+	unsigned int slot = hashMAC(mac);
+
+	while(bridge->mac_tbl[slot].in_use){
+		if(MACcmp(bridge->mac_tbl[slot].mac_addr, mac)){
+			if(isMacEntryExpired(&(bridge->mac_tbl[slot]), time(NULL))){
+				deleteMacEntry(bridge, slot);
+				return NULL;
+			}
+			return &(bridge->mac_tbl[slot]);
+		}
+		slot = (slot + 1) & (BRIDGE_MAC_TBL_SIZE - 1);
+	}
+
+	return NULL;
+}
+
+static void deleteMacEntry(struct bridge* bridge, unsigned int slot){
+
+	unsigned int hole = slot;
+	unsigned int next = slot;
+
+	while(TRUE){
+		next = (next + 1) & (BRIDGE_MAC_TBL_SIZE - 1);
+
+		if(!bridge->mac_tbl[next].in_use){
+			break;
+		}
+
+		//the entry in next can fill the hole if the hole lies
+		//on its probe sequence, i.e. cyclically between the
+		//slot it hashes to and next
+		unsigned int home = hashMAC(bridge->mac_tbl[next].mac_addr);
+		unsigned int dist_to_hole = (hole - home) & (BRIDGE_MAC_TBL_SIZE - 1);
+		unsigned int dist_to_next = (next - home) & (BRIDGE_MAC_TBL_SIZE - 1);
+
+		if(dist_to_hole < dist_to_next){
+			bridge->mac_tbl[hole] = bridge->mac_tbl[next];
+			hole = next;
+		}
+	}
+
+	bridge->mac_tbl[hole].in_use = FALSE;
+	bridge->num_mac_entries--;
+}
+
+static int isMacEntryExpired(struct mac_tbl_entry* mac_entry, time_t now){
+	return difftime(now, mac_entry->last_seen) >= BRIDGE_MAC_AGING_TIME;
+}
+
+static unsigned int hashMAC(const uint8_t* mac){
+
+	//FNV-1a
+	uint32_t hash = 2166136261u;
+	for(int i=0; i<ETHER_ADDR_LEN; i++){
+		hash ^= mac[i];
+		hash *= 16777619u;
+	}
+
+	return hash & (BRIDGE_MAC_TBL_SIZE - 1);
+}
+
+static int isGroupMAC(const uint8_t* mac){
+	//the low bit of the first byte is set for broadcast
+	//and multicast addrs
+	return mac[0] & 1;
+}
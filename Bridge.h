@@ -0,0 +1,137 @@
+/*
+ * Bridge.h
+ */
+
+#ifndef BRIDGE_H
+#define BRIDGE_H
+
+#include <time.h>
+
+#include "sr_router.h"
+
+//name of the bridge virtual interface, which the routing
+//side of the router uses to reach the bridged segments
+#define BRIDGE_VIRTUAL_IFACE_NAME "br0"
+
+//number of slots in the mac learning table, must be a power
+//of 2. No new macs are learned once it is BRIDGE_MAC_TBL_MAX_LOAD
+//full so the probe sequences stay short.
+#define BRIDGE_MAC_TBL_SIZE 1024
+#define BRIDGE_MAC_TBL_MAX_LOAD (BRIDGE_MAC_TBL_SIZE * 3 / 4)
+
+//seconds a learned mac is kept without hearing from it
+#define BRIDGE_MAC_AGING_TIME 300
+
+//seconds between two samples of the flood rate
+#define BRIDGE_STATS_INTERVAL 10
+
+/*A slot of the mac learning table. The table is an open
+ * addressing hash table using linear probing.
+ */
+struct mac_tbl_entry{
+	unsigned char mac_addr[ETHER_ADDR_LEN];
+	unsigned char in_use;
+	struct sr_if* port;	//where the mac was last seen
+	time_t last_seen;
+};
+
+/*An interface that is part of the bridge*/
+struct bridge_port{
+	char name[sr_IFACE_NAMELEN];
+	struct sr_if* iface;	//NULL until bridgeStart, which drops ports without one
+	struct bridge_port* next;
+};
+
+/*The state of the bridge of a router*/
+struct bridge{
+	struct bridge_port* port_list;
+	struct sr_if* bvi;	//the bridge virtual interface
+	struct mac_tbl_entry mac_tbl[BRIDGE_MAC_TBL_SIZE];
+	int num_mac_entries;
+	long num_frames_forwarded;	//known unicast sent out a single port
+	long num_frames_flooded;
+	long num_frames_filtered;	//destination is on the port the frame came from
+	long num_frames_flooded_last_sample;
+	time_t last_sample_time;
+	double flood_rate;	//frames flooded per second over the last sample
+};
+
+/*Bridge the interfaces named instead of routing between them.
+ * Called before the interfaces are known, the bridge starts when
+ * bridgeStart is called.
+ * @param sr the router instance
+ * @param iface_names a comma separated list of interface names
+ */
+void bridgeConfigure(struct sr_instance* sr, const char* iface_names);
+
+/*Start the bridge, once the interfaces are known. Adds the bridge
+ * virtual interface to the interface list, with the ip and mac
+ * addr of the first bridge port. The routing side answers for the
+ * ip and mac addrs of the other ports through it too.
+ * @param sr the router instance
+ */
+void bridgeStart(struct sr_instance* sr);
+
+/*Check to see if the interface is one of the bridge ports
+ * @return 1 if it is a bridge port, 0 otherwise
+ */
+int isBridgePort(struct sr_instance* sr, struct sr_if* iface);
+
+/*Check to see if the interface is the bridge virtual interface
+ * @return 1 if it is, 0 otherwise
+ */
+int isBridgeVirtualInterface(struct sr_instance* sr, struct sr_if* iface);
+
+/*Find the interface the routing side should use in place of
+ * the interface passed in
+ * @return the bridge virtual interface if iface is a bridge
+ * 		port, iface otherwise
+ */
+struct sr_if* bridgeRoutingInterface(struct sr_instance* sr, struct sr_if* iface);
+
+/*Find the bridge port an ip addr is assigned to
+ * @param sr the router instance
+ * @param ip the ip addr, network byte order
+ * @return the interface of the port, or NULL if no port has the
+ * 		ip addr or nothing is bridged
+ */
+struct sr_if* bridgePortWithIP(struct sr_instance* sr, uint32_t ip);
+
+/*Check to see if the mac addr is the mac addr of a bridge port,
+ * the bridge virtual interface's included
+ * @return 1 if it is, 0 otherwise
+ */
+int isBridgeMAC(struct sr_instance* sr, const uint8_t* mac);
+
+/*Learn the source of a frame received on a bridge port and
+ * forward or flood it to the other ports as needed
+ * @param sr the router instance
+ * @param eth_frame the eth frame
+ * @param len the size of the eth frame in bytes
+ * @param port the bridge port the frame was received on
+ * @return the bridge virtual interface if the frame is also for
+ * 		the routing side of this router, NULL if the bridge has
+ * 		taken care of it
+ */
+struct sr_if* bridgeHandleFrame(struct sr_instance* sr, uint8_t* eth_frame, unsigned int len, struct sr_if* port);
+
+/*Send a frame from the bridge virtual interface out the port
+ * its destination was learned on, or flood it to all ports
+ * @param sr the router instance
+ * @param eth_frame the eth frame, headers filled in
+ * @param len the size of the eth frame in bytes
+ */
+void bridgeSendFrame(struct sr_instance* sr, uint8_t* eth_frame, unsigned int len);
+
+/*Age out macs not heard from in a while and sample the flood rate.
+ * Called from the event loop about once a second.
+ * @param sr the router instance
+ */
+void bridgeHandleTimers(struct sr_instance* sr);
+
+/*Prints the size of the mac learning table and the frame
+ * counters of the bridge to stdout
+ */
+void printBridgeStats(struct sr_instance* sr);
+
+#endif /* BRIDGE_H */
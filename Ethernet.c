@@ -16,6 +16,9 @@
 #include "sr_if.h"
 #include "ARP.h"
 #include "ip.h"
+#include "rip.h"
+#include "Bridge.h"
+#include "watchdog.h"
 #include "test.h"
 
 //static void printPacketHeader(struct sr_ethernet_hdr* eth_hdr);
@@ -56,6 +59,8 @@ void handleEthFrame(struct sr_instance* sr, uint8_t * eth_frame, unsigned int le
 	assert(eth_frame);
 	assert(interface);
 
+	WATCHDOG_STAGE(sr, WD_STAGE_ETH);
+
 	//testSendArpRequest(sr);
 	//printf("num of datagram buffers (before): %d\n", sr->num_of_datagram_buffers);
 	//printf("num datagram buffered (before): %d\n", sr->num_datagrams_buffed);
@@ -63,6 +68,16 @@ void handleEthFrame(struct sr_instance* sr, uint8_t * eth_frame, unsigned int le
 	struct sr_ethernet_hdr* eth_hdr = (struct sr_ethernet_hdr*)eth_frame;//cast ethernet header
 	struct sr_if* iface = sr_get_interface(sr, interface); //the interface where the frame is received
 
+	if(isBridgePort(sr, iface)){
+		//the bridge forwards the frame to the other ports if
+		//needed, and tells us whether the routing side should
+		//see it through the bridge virtual interface
+		iface = bridgeHandleFrame(sr, eth_frame, len, iface);
+		if(!iface){
+			return;
+		}
+	}
+
 	unsigned short ether_type = ntohs(eth_hdr->ether_type);
 
 	//printEthMac(sr);
@@ -89,7 +104,7 @@ void handleEthFrame(struct sr_instance* sr, uint8_t * eth_frame, unsigned int le
 
 				uint8_t* ip_datagram = eth_frame + sizeof(struct sr_ethernet_hdr);
 				unsigned int ip_datagram_len = len - sizeof(struct sr_ethernet_hdr);
-				handleIPDatagram(sr, eth_frame, ip_datagram, ip_datagram_len);
+				handleIPDatagram(sr, iface, eth_frame, ip_datagram, ip_datagram_len);
 
 			}
 			else{
@@ -199,7 +214,13 @@ static void sendEthFrame(struct sr_instance* sr, uint8_t* dest_mac, uint8_t * et
 
 	unsigned int frame_len = sizeof(struct sr_ethernet_hdr) + payload_len;
 
-	sr_send_packet( sr, eth_frame, frame_len, iface->name);
+	if(isBridgeVirtualInterface(sr, iface)){
+		//not a real interface, the bridge picks the port(s)
+		bridgeSendFrame(sr, eth_frame, frame_len);
+	}
+	else{
+		sr_send_packet( sr, eth_frame, frame_len, iface->name);
+	}
 }
 
 int MACcmp(const uint8_t* macAddr1, const uint8_t* macAddr2){
@@ -240,7 +261,9 @@ void printEthAddr(uint8_t* eth_hdr){
 }
 
 static int isFrameForMe(struct sr_instance* sr, struct sr_ethernet_hdr* eth_hdr, struct sr_if* iface){
-	return isBroadCastMAC(eth_hdr->ether_dhost) || MACcmp(iface->addr, eth_hdr->ether_dhost);
+	return isBroadCastMAC(eth_hdr->ether_dhost) || MACcmp(iface->addr, eth_hdr->ether_dhost)
+			|| (isBridgeVirtualInterface(sr, iface) && isBridgeMAC(sr, eth_hdr->ether_dhost))
+			|| (isRipMulticastMAC(eth_hdr->ether_dhost) && ripRunsOnInterface(sr, iface));
 }
 
 /*static void printPacketHeader(struct sr_ethernet_hdr* eth_hdr){
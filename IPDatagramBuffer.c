@@ -15,6 +15,7 @@
 #include "sr_protocol.h"
 #include "icmp.h"
 #include "ip.h"
+#include "watchdog.h"
 
 
 /*Try to find a buffer that matches the ip and interface
@@ -43,9 +44,12 @@ static struct datagram_buff* addNewIPDatagramBufferIfNotExist(struct sr_instance
 /*Add the ip datagram into the buffer
  * @param ip_datagram the ip datagram to be added into the buffer
  * @param len the size of the ip datagram in bytes
+ * @param before_send called right before the ip datagram is sent,
+ * 		NULL for none
  * @param buff the buffer where the ip datagram is to be added
  */
-static void addIPDatagramToBuffer(uint8_t * ip_datagram, unsigned int len, struct datagram_buff* buff);
+static void addIPDatagramToBuffer(uint8_t * ip_datagram, unsigned int len,
+		void (*before_send)(struct sr_instance* sr, uint8_t* ip_datagram, unsigned int len), struct datagram_buff* buff);
 
 /*Remove the ip datagram buffer that matches the ip and interface
  * pair if it exists and return the list of ip datagrams in that
@@ -67,19 +71,29 @@ static struct datagram_buff_entry* removeIPDatagramBuffer(struct sr_instance* sr
  * 		structs
  * @param len_buff_ptr the pointer to the buffer used to store the length of
  * 		the extracted datagram
+ * @param before_send_ptr where to put the function to call right before
+ * 		the extracted datagram is sent, may be NULL
  * @return the ip datagram extracted if the list is not empty, NULL otherwise
  */
-static uint8_t* extractNextIPDatagram(struct sr_instance* sr, struct datagram_buff_entry** ip_datagram_list_ptr, unsigned int* len_buff_ptr);
+static uint8_t* extractNextIPDatagram(struct sr_instance* sr, struct datagram_buff_entry** ip_datagram_list_ptr, unsigned int* len_buff_ptr,
+		void (**before_send_ptr)(struct sr_instance* sr, uint8_t* ip_datagram, unsigned int len));
 
 
 void sendBufferedIPDatagrams(struct sr_instance* sr, uint32_t ip, uint8_t* dest_mac, struct sr_if* iface){
 
+	int prev_stage = WATCHDOG_ENTER_STAGE(sr, WD_STAGE_PENDING);
+
 	struct datagram_buff_entry* ip_datagram_list = removeIPDatagramBuffer(sr, ip, iface->name);
 
 	uint8_t* ip_datagram = NULL;
 	unsigned int ip_datagram_len = 0;
+	void (*before_send)(struct sr_instance* sr, uint8_t* ip_datagram, unsigned int len) = NULL;
+
+	while((ip_datagram = extractNextIPDatagram(sr, &ip_datagram_list, &ip_datagram_len, &before_send))){
 
-	while((ip_datagram = extractNextIPDatagram(sr, &ip_datagram_list, &ip_datagram_len))){
+		if(before_send){
+			before_send(sr, ip_datagram, ip_datagram_len);
+		}
 
 		ethSendIPDatagram(sr, dest_mac, ip_datagram, iface, ip_datagram_len);
 
@@ -87,16 +101,19 @@ void sendBufferedIPDatagrams(struct sr_instance* sr, uint32_t ip, uint8_t* dest_
 
 	}
 
+	WATCHDOG_LEAVE_STAGE(sr, prev_stage);
 }
 
 void handleUndeliverableBufferedIPDatagram(struct sr_instance* sr, uint32_t ip, struct sr_if* iface){
 
+	int prev_stage = WATCHDOG_ENTER_STAGE(sr, WD_STAGE_PENDING);
+
 	struct datagram_buff_entry* ip_datagram_list = removeIPDatagramBuffer(sr, ip, iface->name);
 
 	uint8_t* ip_datagram = NULL;
 	unsigned int ip_datagram_len = 0;
 
-	while((ip_datagram = extractNextIPDatagram(sr, &ip_datagram_list, &ip_datagram_len))){
+	while((ip_datagram = extractNextIPDatagram(sr, &ip_datagram_list, &ip_datagram_len, NULL))){
 
 		if( ((struct ip*)ip_datagram)->ip_p != IPPROTO_ICMP ){
 			//only send icmp message about a ip datagram if its payload
@@ -111,9 +128,11 @@ void handleUndeliverableBufferedIPDatagram(struct sr_instance* sr, uint32_t ip,
 
 	}
 
+	WATCHDOG_LEAVE_STAGE(sr, prev_stage);
 }
 
-static uint8_t* extractNextIPDatagram(struct sr_instance* sr, struct datagram_buff_entry** ip_datagram_list_ptr, unsigned int* len_buff_ptr){
+static uint8_t* extractNextIPDatagram(struct sr_instance* sr, struct datagram_buff_entry** ip_datagram_list_ptr, unsigned int* len_buff_ptr,
+		void (**before_send_ptr)(struct sr_instance* sr, uint8_t* ip_datagram, unsigned int len)){
 
 	struct datagram_buff_entry* ip_datagram_container = *ip_datagram_list_ptr;
 
@@ -126,6 +145,10 @@ static uint8_t* extractNextIPDatagram(struct sr_instance* sr, struct datagram_bu
 
 		*len_buff_ptr = ip_datagram_container->len;
 
+		if(before_send_ptr){
+			*before_send_ptr = ip_datagram_container->before_send;
+		}
+
 		*ip_datagram_list_ptr = ip_datagram_container->next;
 
 		free(ip_datagram_container);
@@ -137,11 +160,12 @@ static uint8_t* extractNextIPDatagram(struct sr_instance* sr, struct datagram_bu
 
 }
 
-void bufferIPDatagram(struct sr_instance* sr, uint32_t ip, uint8_t * ip_datagram, char* interface, unsigned int len){
+void bufferIPDatagram(struct sr_instance* sr, uint32_t ip, uint8_t * ip_datagram, char* interface, unsigned int len,
+		void (*before_send)(struct sr_instance* sr, uint8_t* ip_datagram, unsigned int len)){
 
 	struct datagram_buff* buff = addNewIPDatagramBufferIfNotExist(sr, ip, interface);
 
-	addIPDatagramToBuffer(ip_datagram, len, buff);
+	addIPDatagramToBuffer(ip_datagram, len, before_send, buff);
 
 	sr->num_datagrams_buffed++;
 }
@@ -183,7 +207,8 @@ static struct datagram_buff_entry* removeIPDatagramBuffer(struct sr_instance* sr
 
 }
 
-static void addIPDatagramToBuffer(uint8_t * ip_datagram, unsigned int len, struct datagram_buff* buff){
+static void addIPDatagramToBuffer(uint8_t * ip_datagram, unsigned int len,
+		void (*before_send)(struct sr_instance* sr, uint8_t* ip_datagram, unsigned int len), struct datagram_buff* buff){
 
 	//make a copy of the ip datagram to be stored into the buffer
 	uint8_t* ip_datagram_cpy = (uint8_t*) malloc(len);
@@ -193,6 +218,7 @@ static void addIPDatagramToBuffer(uint8_t * ip_datagram, unsigned int len, struc
 	struct datagram_buff_entry* buff_entry = (struct datagram_buff_entry*) malloc(sizeof(struct datagram_buff_entry));
 	buff_entry->ip_datagram = ip_datagram_cpy;
 	buff_entry->len = len;
+	buff_entry->before_send = before_send;
 	buff_entry->next = buff->datagram_buff_entry_list;
 	buff->datagram_buff_entry_list = buff_entry;
 }
@@ -29,6 +29,8 @@ struct datagram_buff{
 struct datagram_buff_entry{
 	uint8_t* ip_datagram;
 	unsigned int len;
+	//called right before the ip datagram is sent, NULL for none
+	void (*before_send)(struct sr_instance* sr, uint8_t* ip_datagram, unsigned int len);
 	struct datagram_buff_entry* next;
 };
 
@@ -51,8 +53,11 @@ void sendBufferedIPDatagrams(struct sr_instance* sr, uint32_t ip, uint8_t* dest_
  * @param interface the name of the interface where the eth frame
  * 		encapsulating the ip datagram is to be sent
  * @param len the size of the ip datagram in bytes
+ * @param before_send called on the buffered copy right before it
+ * 		is sent, e.g. to timestamp it, NULL for none
  */
-void bufferIPDatagram(struct sr_instance* sr, uint32_t ip, uint8_t * ip_datagram, char* interface, unsigned int len);
+void bufferIPDatagram(struct sr_instance* sr, uint32_t ip, uint8_t * ip_datagram, char* interface, unsigned int len,
+		void (*before_send)(struct sr_instance* sr, uint8_t* ip_datagram, unsigned int len));
 
 /*Tell the buffer the handle any buffered ip datagrams that can't
  * be delivered
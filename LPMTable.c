@@ -0,0 +1,321 @@
+/*
+ * LPMTable.c
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <arpa/inet.h>
+
+#include "LPMTable.h"
+#include "Defs.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define LPM_TABLE_HAVE_AVX2 1
+#include <immintrin.h>
+#endif
+
+/*Search all entries of the lpm_table for the largest ranking key
+ * among the entries matching the destination ip addr
+ * @param tbl the lpm_table
+ * @param dest_ip the destination ip addr in host byte order
+ * @return the largest ranking key, 0 if no entry matches
+ */
+static uint32_t searchScalar(struct lpm_table* tbl, uint32_t dest_ip);
+
+#ifdef LPM_TABLE_HAVE_AVX2
+/*Same as searchScalar but compares LPM_TABLE_LANES entries
+ * at a time using AVX2 instructions. Only called when the cpu
+ * supports AVX2.
+ */
+static uint32_t searchAVX2(struct lpm_table* tbl, uint32_t dest_ip);
+#endif
+
+/*Allocate an array of uint32_t aligned to LPM_TABLE_ALIGN
+ * @param n the number of elements
+ * @return the array, with all elements set to 0
+ */
+static uint32_t* allocAlignedArray(unsigned int n);
+
+/*Double the size of the arrays of the lpm_table, keeping
+ * the entries
+ * @param tbl the lpm_table
+ */
+static void growLPMTable(struct lpm_table* tbl);
+
+/*Replace an aligned array with a larger copy of it
+ * @param array the array, freed
+ * @param n the number of elements in use
+ * @param capacity the size of the new array
+ * @return the new array, the elements past n set to 0
+ */
+static uint32_t* growAlignedArray(uint32_t* array, unsigned int n, unsigned int capacity);
+
+/*Fill in slot i of the lpm_table from the routing table entry
+ * @param tbl the lpm_table
+ * @param i the slot
+ * @param rt_entry the routing table entry
+ */
+static void setLPMTableEntry(struct lpm_table* tbl, unsigned int i, struct sr_rt* rt_entry);
+
+/*Zero out slot i of the lpm_table so it never matches
+ * @param tbl the lpm_table
+ * @param i the slot
+ */
+static void clearLPMTableEntry(struct lpm_table* tbl, unsigned int i);
+
+/*Pick the search routine to use on this cpu. Done once, the
+ * first time a lpm_table is created.
+ */
+static void selectSearch(void);
+
+static uint32_t (*search)(struct lpm_table* tbl, uint32_t dest_ip) = NULL;
+
+
+struct lpm_table* createLPMTable(struct sr_rt* routing_table){
+
+	unsigned int num_entries = 0;
+	struct sr_rt* rt_entry = routing_table;
+	while(rt_entry){
+		num_entries++;
+		if(num_entries > LPM_TABLE_MAX_ENTRIES){
+			//the index wouldn't fit in the ranking key
+			return NULL;
+		}
+		rt_entry = rt_entry->next;
+	}
+
+	selectSearch();
+
+	struct lpm_table* tbl = (struct lpm_table*) malloc(sizeof(struct lpm_table));
+	assert(tbl);
+
+	//leave room to add a few routes and round up to a whole
+	//number of lanes, the padding entries are left with a
+	//ranking key of 0 so they never win
+	unsigned int capacity = (num_entries > LPM_TABLE_INITIAL_CAPACITY) ? num_entries : LPM_TABLE_INITIAL_CAPACITY;
+	tbl->capacity = ((capacity + LPM_TABLE_LANES - 1) / LPM_TABLE_LANES) * LPM_TABLE_LANES;
+	tbl->num_entries = num_entries;
+	tbl->dest = allocAlignedArray(tbl->capacity);
+	tbl->mask = allocAlignedArray(tbl->capacity);
+	tbl->plen_key = allocAlignedArray(tbl->capacity);
+	tbl->rt_entries = (struct sr_rt**) calloc(tbl->capacity, sizeof(struct sr_rt*));
+	assert(tbl->rt_entries);
+
+	unsigned int i = 0;
+	for(rt_entry = routing_table; rt_entry; rt_entry = rt_entry->next, i++){
+		setLPMTableEntry(tbl, i, rt_entry);
+	}
+
+	return tbl;
+}
+
+int addLPMTableEntry(struct lpm_table* tbl, struct sr_rt* rt_entry){
+
+	assert(tbl);
+	assert(rt_entry);
+
+	if(tbl->num_entries >= LPM_TABLE_MAX_ENTRIES){
+		return FALSE;
+	}
+
+	if(tbl->num_entries >= tbl->capacity){
+		growLPMTable(tbl);
+	}
+
+	setLPMTableEntry(tbl, tbl->num_entries, rt_entry);
+	tbl->num_entries++;
+
+	return TRUE;
+}
+
+void removeLPMTableEntry(struct lpm_table* tbl, struct sr_rt* rt_entry){
+
+	assert(tbl);
+	assert(rt_entry);
+
+	for(unsigned int i = 0; i < tbl->num_entries; i++){
+		if(tbl->rt_entries[i] == rt_entry){
+			//shift the entries after it down one slot, so the
+			//indices keep following the order of the list and
+			//ties are broken the same way as lookupRoutingTableList
+			unsigned int last = tbl->num_entries - 1;
+			for(unsigned int j = i; j < last; j++){
+				setLPMTableEntry(tbl, j, tbl->rt_entries[j + 1]);
+			}
+			clearLPMTableEntry(tbl, last);
+			tbl->num_entries--;
+			return;
+		}
+	}
+}
+
+void destroyLPMTable(struct lpm_table* tbl){
+
+	if(!tbl){
+		return;
+	}
+
+	free(tbl->dest);
+	free(tbl->mask);
+	free(tbl->plen_key);
+	free(tbl->rt_entries);
+	free(tbl);
+}
+
+struct sr_rt* lookupLPMTable(struct lpm_table* tbl, uint32_t dest_host_ip){
+
+	assert(tbl);
+
+	uint32_t best_key = search(tbl, ntohl(dest_host_ip));
+
+	if(best_key == 0){
+		//nothing matched
+		return NULL;
+	}
+
+	return tbl->rt_entries[0xffff - (best_key & 0xffff)];
+}
+
+struct sr_rt* lookupRoutingTableList(struct sr_rt* routing_table, uint32_t dest_host_ip){
+
+	struct sr_rt* current_rt_entry = routing_table;
+
+	//this variable stores the mask of the current
+	//longest prefix matching the dest_host_ip
+	uint32_t longest_mask = 0;
+	struct sr_rt* rt_entry_with_longest_prefix = NULL;
+
+	while(current_rt_entry){
+
+		uint32_t mask = ntohl(current_rt_entry->mask.s_addr);
+		uint32_t masked_rt_dest_ip = ntohl(current_rt_entry->dest.s_addr) & mask;
+		uint32_t masked_dest_host_ip =  ntohl(dest_host_ip) & mask;
+
+		if((masked_rt_dest_ip == masked_dest_host_ip)
+				&& ((!rt_entry_with_longest_prefix) || (mask > longest_mask))){
+			longest_mask = mask;
+			rt_entry_with_longest_prefix = current_rt_entry;
+		}
+
+		current_rt_entry = current_rt_entry->next;
+
+	}
+
+	return rt_entry_with_longest_prefix;
+}
+
+static uint32_t searchScalar(struct lpm_table* tbl, uint32_t dest_ip){
+
+	uint32_t best_key = 0;
+
+	for(unsigned int i = 0; i < tbl->num_entries; i++){
+		if(((dest_ip & tbl->mask[i]) == tbl->dest[i]) && (tbl->plen_key[i] > best_key)){
+			best_key = tbl->plen_key[i];
+		}
+	}
+
+	return best_key;
+}
+
+#ifdef LPM_TABLE_HAVE_AVX2
+__attribute__((target("avx2")))
+static uint32_t searchAVX2(struct lpm_table* tbl, uint32_t dest_ip){
+
+	__m256i dest = _mm256_set1_epi32((int) dest_ip);
+	__m256i best = _mm256_setzero_si256();
+
+	//slots past num_entries are cleared, so the partly used
+	//last group of lanes can be compared as a whole
+	for(unsigned int i = 0; i < tbl->num_entries; i += LPM_TABLE_LANES){
+		__m256i mask = _mm256_load_si256((const __m256i*)(tbl->mask + i));
+		__m256i rt_dest = _mm256_load_si256((const __m256i*)(tbl->dest + i));
+		__m256i key = _mm256_load_si256((const __m256i*)(tbl->plen_key + i));
+
+		//all ones in the lanes whose entry matches, then keep
+		//the ranking key of those lanes only
+		__m256i match = _mm256_cmpeq_epi32(_mm256_and_si256(dest, mask), rt_dest);
+		best = _mm256_max_epu32(best, _mm256_and_si256(match, key));
+	}
+
+	//horizontal max across the 8 lanes
+	__m128i m = _mm_max_epu32(_mm256_castsi256_si128(best), _mm256_extracti128_si256(best, 1));
+	m = _mm_max_epu32(m, _mm_shuffle_epi32(m, _MM_SHUFFLE(1, 0, 3, 2)));
+	m = _mm_max_epu32(m, _mm_shuffle_epi32(m, _MM_SHUFFLE(2, 3, 0, 1)));
+
+	return (uint32_t) _mm_cvtsi128_si32(m);
+}
+#endif
+
+static void setLPMTableEntry(struct lpm_table* tbl, unsigned int i, struct sr_rt* rt_entry){
+
+	uint32_t mask = ntohl(rt_entry->mask.s_addr);
+	uint32_t plen = __builtin_popcount(mask);
+
+	tbl->mask[i] = mask;
+	tbl->dest[i] = ntohl(rt_entry->dest.s_addr) & mask;
+	tbl->plen_key[i] = ((plen + 1) << 16) | (0xffff - i);
+	tbl->rt_entries[i] = rt_entry;
+}
+
+static void clearLPMTableEntry(struct lpm_table* tbl, unsigned int i){
+
+	tbl->mask[i] = 0;
+	tbl->dest[i] = 0;
+	tbl->plen_key[i] = 0;
+	tbl->rt_entries[i] = NULL;
+}
+
+static void selectSearch(void){
+
+	if(search){
+		return;
+	}
+
+	search = searchScalar;
+
+#ifdef LPM_TABLE_HAVE_AVX2
+	__builtin_cpu_init();
+	if(__builtin_cpu_supports("avx2")){
+		search = searchAVX2;
+	}
+#endif
+}
+
+static uint32_t* allocAlignedArray(unsigned int n){
+
+	void* array = NULL;
+	int status = posix_memalign(&array, LPM_TABLE_ALIGN, n * sizeof(uint32_t));
+	assert(status == 0);
+
+	for(unsigned int i = 0; i < n; i++){
+		((uint32_t*) array)[i] = 0;
+	}
+
+	return (uint32_t*) array;
+}
+
+static void growLPMTable(struct lpm_table* tbl){
+
+	//capacity stays a multiple of LPM_TABLE_LANES
+	unsigned int capacity = tbl->capacity * 2;
+
+	tbl->dest = growAlignedArray(tbl->dest, tbl->num_entries, capacity);
+	tbl->mask = growAlignedArray(tbl->mask, tbl->num_entries, capacity);
+	tbl->plen_key = growAlignedArray(tbl->plen_key, tbl->num_entries, capacity);
+
+	tbl->rt_entries = (struct sr_rt**) realloc(tbl->rt_entries, capacity * sizeof(struct sr_rt*));
+	assert(tbl->rt_entries);
+	memset(tbl->rt_entries + tbl->num_entries, 0, (capacity - tbl->num_entries) * sizeof(struct sr_rt*));
+
+	tbl->capacity = capacity;
+}
+
+static uint32_t* growAlignedArray(uint32_t* array, unsigned int n, unsigned int capacity){
+
+	uint32_t* new_array = allocAlignedArray(capacity);
+	memcpy(new_array, array, n * sizeof(uint32_t));
+	free(array);
+
+	return new_array;
+}
@@ -0,0 +1,101 @@
+/*
+ * LPMTable.h
+ */
+
+#ifndef LPM_TABLE_H
+#define LPM_TABLE_H
+
+#include <stdint.h>
+
+#include "sr_rt.h"
+
+//the ranking key keeps the index of an entry in 16 bits, so
+//larger routing tables are searched by walking the list instead
+#define LPM_TABLE_MAX_ENTRIES 0xffff
+
+//the arrays of a new lpm_table have room for at least this many
+//entries, they are doubled whenever they fill up
+#define LPM_TABLE_INITIAL_CAPACITY 64
+
+//number of entries compared per step, also the granularity
+//the arrays of the lpm_table are padded to
+#define LPM_TABLE_LANES 8
+
+//alignment in bytes of the arrays of the lpm_table
+#define LPM_TABLE_ALIGN 32
+
+/*A copy of the routing table packed into structure of
+ * arrays form so every entry can be compared against a
+ * destination ip addr without following any pointers.
+ * All addresses are in host byte order.
+ *
+ * The prefix length of each entry is stored together with
+ * the entry's position as a ranking key:
+ * 		(prefix_len + 1) << 16 | (0xffff - index)
+ * so the largest key among the matching entries is the
+ * longest prefix match, ties going to the entry with the
+ * lower index. Padding entries have a key of 0.
+ *
+ * Entries are kept in the order of the routing table list, so
+ * ties between equal prefixes go to the entry that comes first
+ * in the list, as with lookupRoutingTableList. Routes are added
+ * and removed in place, the arrays are grown as needed.
+ */
+struct lpm_table{
+	uint32_t* dest;		//dest & mask of each entry
+	uint32_t* mask;
+	uint32_t* plen_key;	//ranking key, see above
+	struct sr_rt** rt_entries;	//the routing table entry each index came from
+	unsigned int num_entries;
+	unsigned int capacity;	//size of the arrays, a multiple of LPM_TABLE_LANES
+};
+
+/*Pack the routing table list into a new lpm_table
+ * @param routing_table the first entry of the routing table list
+ * @return the lpm_table, or NULL if the routing table has more
+ * 		than LPM_TABLE_MAX_ENTRIES entries
+ */
+struct lpm_table* createLPMTable(struct sr_rt* routing_table);
+
+/*Free the lpm_table and its arrays. The routing table
+ * entries it refers to are not freed.
+ * @param tbl the lpm_table, may be NULL
+ */
+void destroyLPMTable(struct lpm_table* tbl);
+
+/*Add a routing table entry to the end of the lpm_table
+ * @param tbl the lpm_table
+ * @param rt_entry the routing table entry just added to the list
+ * @return 1 if the entry was added, 0 if the lpm_table already
+ * 		has LPM_TABLE_MAX_ENTRIES entries
+ */
+int addLPMTableEntry(struct lpm_table* tbl, struct sr_rt* rt_entry);
+
+/*Remove a routing table entry from the lpm_table. The entries
+ * after it are moved down one slot so they stay contiguous and
+ * in list order.
+ * @param tbl the lpm_table
+ * @param rt_entry the routing table entry about to be removed
+ * 		from the list
+ */
+void removeLPMTableEntry(struct lpm_table* tbl, struct sr_rt* rt_entry);
+
+/*Find the entry of the lpm_table with the longest prefix match
+ * against the destination ip addr
+ * @param tbl the lpm_table
+ * @param dest_host_ip the destination ip addr in network byte order
+ * @return the routing table entry with the longest prefix match,
+ * 		or NULL if no entry matches
+ */
+struct sr_rt* lookupLPMTable(struct lpm_table* tbl, uint32_t dest_host_ip);
+
+/*Find the entry of the routing table list with the longest prefix
+ * match against the destination ip addr by walking the list
+ * @param routing_table the first entry of the routing table list
+ * @param dest_host_ip the destination ip addr in network byte order
+ * @return the routing table entry with the longest prefix match,
+ * 		or NULL if no entry matches
+ */
+struct sr_rt* lookupRoutingTableList(struct sr_rt* routing_table, uint32_t dest_host_ip);
+
+#endif /* LPM_TABLE_H */
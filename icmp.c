@@ -5,6 +5,7 @@
 #include "icmp.h"
 #include "ip.h"
 #include "sr_protocol.h"
+#include "watchdog.h"
 
 /*Checks to see if the icmp checksum of the icmp received
  * is correct
@@ -96,6 +97,8 @@ void destinationUnreachable(struct sr_instance* sr, uint8_t * ip_datagram, unsig
 
 static void sendIcmpMessage(struct sr_instance* sr, uint8_t * ip_datagram, unsigned int ip_datagram_len, unsigned short type, unsigned short code){
 
+	int prev_stage = WATCHDOG_ENTER_STAGE(sr, WD_STAGE_ICMP);
+
 	unsigned int icmp_msg_len = calculateIcmpMsgLen(ip_datagram_len);
 	uint8_t* icmp_msg = (uint8_t*) malloc(icmp_msg_len);
 	bzero(icmp_msg, icmp_msg_len);
@@ -128,6 +131,7 @@ static void sendIcmpMessage(struct sr_instance* sr, uint8_t * ip_datagram, unsig
 
 	sr->num_icmp_messages_created++;
 
+	WATCHDOG_LEAVE_STAGE(sr, prev_stage);
 }
 
 static void setupIcmpHeader(uint8_t* icmp_msg, unsigned int icmp_msg_len, uint8_t type, uint8_t code){
@@ -168,9 +172,12 @@ void handleIcmpMessageReceived(struct sr_instance* sr, uint8_t * ip_datagram, un
 	assert(sr);
 	assert(ip_datagram);
 
+	int prev_stage = WATCHDOG_ENTER_STAGE(sr, WD_STAGE_ICMP);
+
 	if(ip_datagram_len < (sizeof(struct ip) + ICMP_HDR_LEN)){
 		//the ip datagram is too small to be to have a valid header
 		//and coontain a valid icmp message. can't process it, return
+		WATCHDOG_LEAVE_STAGE(sr, prev_stage);
 		return;
 	}
 
@@ -181,6 +188,7 @@ void handleIcmpMessageReceived(struct sr_instance* sr, uint8_t * ip_datagram, un
 	if(!checksumCorrect(icmp_hdr, (uint16_t*)icmp_msg, icmp_msg_len)){
 		//the calculated checksum is not the same as the checksum
 		//in the icmp message, drop it
+		WATCHDOG_LEAVE_STAGE(sr, prev_stage);
 		return;
 	}
 
@@ -189,6 +197,7 @@ void handleIcmpMessageReceived(struct sr_instance* sr, uint8_t * ip_datagram, un
 		//request, this router currently can only handle
 		//icmp echo request. We just return and drop the
 		//ip datagram
+		WATCHDOG_LEAVE_STAGE(sr, prev_stage);
 		return;
 	}
 
@@ -206,6 +215,8 @@ void handleIcmpMessageReceived(struct sr_instance* sr, uint8_t * ip_datagram, un
 	ipSendIcmpMessageWithSrcIP(sr, icmp_msg, icmp_msg_len, dest_ip, src_ip);
 
 	sr->num_icmp_messages_created++;
+
+	WATCHDOG_LEAVE_STAGE(sr, prev_stage);
 }
 
 static int checksumCorrect(struct icmphdr* icmp_hdr, uint16_t* icmp_msg, unsigned int icmp_msg_len){
@@ -10,6 +10,11 @@
 #include "Ethernet.h"
 #include "sr_rt.h"
 #include "sr_if.h"
+#include "LPMTable.h"
+#include "udp.h"
+#include "rip.h"
+#include "Bridge.h"
+#include "watchdog.h"
 
 
 //static void printIPDatagram(struct ip* ip_hdr, uint8_t* ip_datagram, unsigned int ip_datagram_len, char* title);
@@ -35,19 +40,21 @@ static void forward(struct sr_instance* sr, uint8_t* eth_frame, uint8_t* ip_data
 
 /*Process the ip datagram for which this router is the destination host
  * @param sr the router instance
+ * @param iface the interface the ip datagram was received on
  * @param eth_frame the eth frame encapsulating the ip datagram
  * @param ip_datagram the ip datagram
  * @param ip_datagram_len the size of the ip datagram in bytes
  */
-static void processIPDatagramDestinedForMe(struct sr_instance* sr, uint8_t* eth_frame, uint8_t* ip_datagram, unsigned int ip_datagram_len);
+static void processIPDatagramDestinedForMe(struct sr_instance* sr, struct sr_if* iface, uint8_t* eth_frame, uint8_t* ip_datagram, unsigned int ip_datagram_len);
 
 /*Check to see if this router is the destination host for the
  * ip datagram
  *@param sr the router instance
+ *@param iface the interface the ip datagram was received on
  *@param dest_host_ip the destination host ip
  *@return 1 if this router is the destination host, 0 otherwise
  */
-static int ipDatagramDestinedForMe(struct sr_instance* sr, uint32_t dest_host_ip);
+static int ipDatagramDestinedForMe(struct sr_instance* sr, struct sr_if* iface, uint32_t dest_host_ip);
 
 /*Checks the header of the ip datagram to determine if the ip
  * datagram should be dropped by the router
@@ -62,6 +69,12 @@ static int ipDatagramShouldBeDropped(struct ip ip_hdr);
  */
 static void ip_dec_ttl(struct ip* ip_hdr);
 
+/*Resolve the mac addr of the next hop and send the ip datagram,
+ * or buffer it until the arp reply comes in. The ttl is left as is.
+ * Takes the same parameters as sendIPDatagram.
+ */
+static void transmitIPDatagram(struct sr_instance* sr, uint32_t next_hop_ip, char* interface, uint8_t* ip_datagram, uint8_t* eth_frame, unsigned int ip_datagram_len);
+
 /*Set up the header for the ip datagram encapsulating an icmp
  * message
  *@param ip_hdr the ip header
@@ -75,7 +88,9 @@ static void ip_dec_ttl(struct ip* ip_hdr);
 static void setupIPHeaderForICMP(struct ip* ip_hdr, uint16_t ip_datagram_total_len, uint32_t src_ip, uint32_t dest_ip);
 
 
-void handleIPDatagram(struct sr_instance* sr, uint8_t* eth_frame, uint8_t* ip_datagram, unsigned int ip_datagram_len){
+void handleIPDatagram(struct sr_instance* sr, struct sr_if* iface, uint8_t* eth_frame, uint8_t* ip_datagram, unsigned int ip_datagram_len){
+
+	WATCHDOG_STAGE(sr, WD_STAGE_IP);
 
 	/*this is the entry point into the ip layer. This method
 	 * will be called by the ethernet layer when it received an ip
@@ -121,8 +136,8 @@ void handleIPDatagram(struct sr_instance* sr, uint8_t* eth_frame, uint8_t* ip_da
 		return;
 	}
 
-	if(ipDatagramDestinedForMe(sr, ip_hdr->ip_dst.s_addr)){
-		processIPDatagramDestinedForMe(sr, eth_frame, ip_datagram, ip_datagram_len);
+	if(ipDatagramDestinedForMe(sr, iface, ip_hdr->ip_dst.s_addr)){
+		processIPDatagramDestinedForMe(sr, iface, eth_frame, ip_datagram, ip_datagram_len);
 	}
 	else if(ip_hdr->ip_ttl > 1){
 		//ttl greater than 1, we can try to forward it
@@ -138,7 +153,7 @@ void handleIPDatagram(struct sr_instance* sr, uint8_t* eth_frame, uint8_t* ip_da
 
 }
 
-static void processIPDatagramDestinedForMe(struct sr_instance* sr, uint8_t* eth_frame, uint8_t* ip_datagram, unsigned int ip_datagram_len){
+static void processIPDatagramDestinedForMe(struct sr_instance* sr, struct sr_if* iface, uint8_t* eth_frame, uint8_t* ip_datagram, unsigned int ip_datagram_len){
 
 	struct ip* ip_hdr = (struct ip*)ip_datagram;
 
@@ -147,9 +162,20 @@ static void processIPDatagramDestinedForMe(struct sr_instance* sr, uint8_t* eth_
 		//call the icmp component to handle it
 		handleIcmpMessageReceived(sr, ip_datagram, ip_datagram_len);
 	}
-	else if( (ip_hdr->ip_p == IPPROTO_UDP) || (ip_hdr->ip_p == IPPROTO_TCP) ){
+	else if(ip_hdr->ip_p == IPPROTO_UDP){
+		//hand it to the service running on this router, e.g. rip,
+		//listening on the port. For ping to work properly a port
+		//unreachable is sent if there is none.
+		if(handleUdpSegment(sr, iface, ip_datagram, ip_datagram_len) == UDP_PORT_UNREACHABLE){
+			destinationUnreachable(sr, ip_datagram, ip_datagram_len, ICMP_CODE_PORT_UNREACHABLE);
+		}
+	}
+	else if(IN_MULTICAST(ntohl(ip_hdr->ip_dst.s_addr))){
+		//no icmp errors about multicast datagrams (rfc 1122)
+	}
+	else if(ip_hdr->ip_p == IPPROTO_TCP){
 		//for ping to work properly we need to use this even
-		//though the router is not running UDP or TCP
+		//though the router is not running TCP
 		destinationUnreachable(sr, ip_datagram, ip_datagram_len, ICMP_CODE_PORT_UNREACHABLE);
 	}
 	else{
@@ -164,15 +190,20 @@ static void processIPDatagramDestinedForMe(struct sr_instance* sr, uint8_t* eth_
 	sr->num_ip_datagrams_dropped++;
 }
 
-static int ipDatagramDestinedForMe(struct sr_instance* sr, uint32_t dest_host_ip){
+static int ipDatagramDestinedForMe(struct sr_instance* sr, struct sr_if* iface, uint32_t dest_host_ip){
 
-	struct sr_if* iface = sr->if_list;
+	if((dest_host_ip == htonl(RIP_MULTICAST_IP)) && ripRunsOnInterface(sr, iface)){
+		//rip update from a neighbour
+		return TRUE;
+	}
 
-	while(iface){
-		if(iface->ip == dest_host_ip){
+	struct sr_if* current_iface = sr->if_list;
+
+	while(current_iface){
+		if(current_iface->ip == dest_host_ip){
 			return TRUE;
 		}
-		iface = iface->next;
+		current_iface = current_iface->next;
 	}
 
 	return FALSE;
@@ -201,36 +232,44 @@ static void forward(struct sr_instance* sr, uint8_t* eth_frame, uint8_t* ip_data
 
 static struct sr_rt* lookupRoutingTable(struct sr_instance* sr, uint32_t dest_host_ip){
 
-	struct sr_rt* current_rt_entry = sr->routing_table;
+	struct sr_rt* rt_entry = NULL;
 
-	//this variable stores the current longest ip prefix
-	//matching the dest_host_ip
-	uint32_t longest_prefix = 0;
-	struct sr_rt* rt_entry_with_longest_prefix = NULL;
+	int prev_stage = WATCHDOG_ENTER_STAGE(sr, WD_STAGE_LOOKUP);
 
-	while(current_rt_entry){
+	if(sr->lpm_table){
+		//the routing table is small enough to have been
+		//packed, compare against all entries at once
+		rt_entry = lookupLPMTable(sr->lpm_table, dest_host_ip);
+	}
+	else{
+		rt_entry = lookupRoutingTableList(sr->routing_table, dest_host_ip);
+	}
 
-		uint32_t masked_rt_dest_ip = ntohl(current_rt_entry->dest.s_addr) & ntohl(current_rt_entry->mask.s_addr);
-		uint32_t masked_dest_host_ip =  ntohl(dest_host_ip) & ntohl(current_rt_entry->mask.s_addr);
+	WATCHDOG_LEAVE_STAGE(sr, prev_stage);
 
-		if((masked_rt_dest_ip == masked_dest_host_ip) && (masked_dest_host_ip >= longest_prefix)){
-			longest_prefix = masked_dest_host_ip;
-			rt_entry_with_longest_prefix = current_rt_entry;
-		}
+	return rt_entry;
 
-		current_rt_entry = current_rt_entry->next;
+}
 
-	}
+void sendIPDatagram(struct sr_instance* sr, uint32_t next_hop_ip, char* interface, uint8_t* ip_datagram, uint8_t* eth_frame, unsigned int ip_datagram_len){
 
-	return rt_entry_with_longest_prefix;
+	ip_dec_ttl((struct ip*) ip_datagram);
 
+	transmitIPDatagram(sr, next_hop_ip, interface, ip_datagram, eth_frame, ip_datagram_len);
 }
 
-void sendIPDatagram(struct sr_instance* sr, uint32_t next_hop_ip, char* interface, uint8_t* ip_datagram, uint8_t* eth_frame, unsigned int ip_datagram_len){
+void sendLocalIPDatagram(struct sr_instance* sr, uint32_t next_hop_ip, char* interface, uint8_t* ip_datagram, unsigned int ip_datagram_len){
 
-	ip_dec_ttl((struct ip*) ip_datagram);
+	//the datagram starts here, so it goes out with the
+	//ttl it was created with
+	transmitIPDatagram(sr, next_hop_ip, interface, ip_datagram, NULL, ip_datagram_len);
+}
 
-	struct sr_if* iface = sr_get_interface(sr, interface);
+static void transmitIPDatagram(struct sr_instance* sr, uint32_t next_hop_ip, char* interface, uint8_t* ip_datagram, uint8_t* eth_frame, unsigned int ip_datagram_len){
+
+	//routes through a bridge port go out the bridge
+	//virtual interface, which does the arp resolution
+	struct sr_if* iface = bridgeRoutingInterface(sr, sr_get_interface(sr, interface));
 
 	uint8_t mac[ETHER_ADDR_LEN];
 	int resolveStatus = resolveMAC(sr, next_hop_ip, iface, mac);
@@ -263,7 +302,9 @@ void sendIPDatagram(struct sr_instance* sr, uint32_t next_hop_ip, char* interfac
 		}
 		case(ARP_REQUEST_SENT):
 		{
-			bufferIPDatagram(sr, next_hop_ip, ip_datagram, interface, ip_datagram_len);
+			//the buffer keeps the name around, use the interface's
+			//copy since routing table entries can now go away
+			bufferIPDatagram(sr, next_hop_ip, ip_datagram, iface->name, ip_datagram_len, NULL);
 			//printf("ip packet buffered\n");
 			break;
 		}
@@ -343,8 +384,84 @@ void ipSendIcmpMessageWithSrcIP(struct sr_instance* sr, uint8_t* icmp_message, u
 	}
 }
 
+int ipSendUdpDatagram(struct sr_instance* sr, uint32_t src_ip, uint32_t dest_ip, uint16_t src_port, uint16_t dest_port, uint8_t ttl, uint8_t* payload, unsigned int payload_len){
+
+	assert(sr);
+	assert(payload);
+	assert(src_ip);
+	assert(dest_ip);
+
+	struct sr_rt* rt_entry_with_longest_prefix = lookupRoutingTable(sr, dest_ip);
+
+	if(!rt_entry_with_longest_prefix){
+		//no way to reach the destination
+		return FALSE;
+	}
+
+	uint8_t* ip_datagram = createUdpDatagram(src_ip, dest_ip, src_port, dest_port, ttl, payload, payload_len);
+	unsigned int ip_datagram_len = sizeof(struct ip) + UDP_HDR_LEN + payload_len;
+
+	//a directly connected subnet has no gateway, the
+	//destination itself is the next hop
+	uint32_t next_hop_ip = rt_entry_with_longest_prefix->gw.s_addr ? rt_entry_with_longest_prefix->gw.s_addr : dest_ip;
+	char* interface = rt_entry_with_longest_prefix->interface;
+	sendLocalIPDatagram(sr, next_hop_ip, interface, ip_datagram, ip_datagram_len);
+
+	free(ip_datagram);
+
+	return TRUE;
+}
+
+int ipSendStampedDatagram(struct sr_instance* sr, uint8_t* ip_datagram, unsigned int ip_datagram_len,
+		void (*before_send)(struct sr_instance* sr, uint8_t* ip_datagram, unsigned int len)){
+
+	assert(sr);
+	assert(ip_datagram);
+	assert(before_send);
+
+	uint32_t dest_ip = ((struct ip*)ip_datagram)->ip_dst.s_addr;
+	struct sr_rt* rt_entry_with_longest_prefix = lookupRoutingTable(sr, dest_ip);
+
+	if(!rt_entry_with_longest_prefix){
+		return FALSE;
+	}
+
+	uint32_t next_hop_ip = rt_entry_with_longest_prefix->gw.s_addr ? rt_entry_with_longest_prefix->gw.s_addr : dest_ip;
+	struct sr_if* iface = bridgeRoutingInterface(sr, sr_get_interface(sr, rt_entry_with_longest_prefix->interface));
+
+	uint8_t mac[ETHER_ADDR_LEN];
+
+	switch(resolveMAC(sr, next_hop_ip, iface, mac)){
+		case(ARP_RESOLVE_SUCCESS):
+		{
+			before_send(sr, ip_datagram, ip_datagram_len);
+			ethSendIPDatagram(sr, mac, ip_datagram, iface, ip_datagram_len);
+			return TRUE;
+		}
+		case(ARP_REQUEST_SENT):
+		{
+			//stamped when the arp reply lets it out
+			bufferIPDatagram(sr, next_hop_ip, ip_datagram, iface->name, ip_datagram_len, before_send);
+			return TRUE;
+		}
+		default:
+		{
+			//the next hop is gone. No icmp error, the datagram
+			//was originated here
+			handleUndeliverableBufferedIPDatagram(sr, next_hop_ip, iface);
+			return FALSE;
+		}
+	}
+}
+
 static void setupIPHeaderForICMP(struct ip* ip_hdr, uint16_t ip_datagram_total_len, uint32_t src_ip, uint32_t dest_ip){
 
+	setupIPHeader(ip_hdr, ip_datagram_total_len, IPPROTO_ICMP, DEFAULT_IP_TTL, src_ip, dest_ip);
+
+}
+
+void setupIPHeader(struct ip* ip_hdr, uint16_t ip_datagram_total_len, uint8_t protocol, uint8_t ttl, uint32_t src_ip, uint32_t dest_ip){
+
 	ip_hdr->ip_v = IPV4_VERSION;
 	ip_hdr->ip_hl = DEFAULT_IP_HEADER_LEN;
 	ip_hdr->ip_tos = DEFAULT_IP_TOS;
@@ -353,8 +470,8 @@ static void setupIPHeaderForICMP(struct ip* ip_hdr, uint16_t ip_datagram_total_l
 	ip_hdr->ip_id = htons(DEFAULT_IP_ID);
 	ip_hdr->ip_off = htons(DEFAULT_IP_FRAGMENT);
 
-	ip_hdr->ip_ttl = DEFAULT_IP_TTL;
-	ip_hdr->ip_p = IPPROTO_ICMP;
+	ip_hdr->ip_ttl = ttl;
+	ip_hdr->ip_p = protocol;
 
 	ip_hdr->ip_src.s_addr = src_ip;
 
@@ -13,11 +13,12 @@
 
 /*Handle an ip datagram this router has received
  * @param sr the router instance
+ * @param iface the interface the ip datagram was received on
  * @param eth_frame the eth frame encapsulating the ip datagram
  * @param ip_datagram the ip datagram received
  * @param ip_datagram_len the size of the ip datagram in bytes
  */
-void handleIPDatagram(struct sr_instance* sr, uint8_t* eth_frame, uint8_t* ip_datagram, unsigned int ip_datagram_len);
+void handleIPDatagram(struct sr_instance* sr, struct sr_if* iface, uint8_t* eth_frame, uint8_t* ip_datagram, unsigned int ip_datagram_len);
 
 /*Send an ip datagram
  * @param sr the router instance
@@ -32,6 +33,17 @@ void handleIPDatagram(struct sr_instance* sr, uint8_t* eth_frame, uint8_t* ip_da
  */
 void sendIPDatagram(struct sr_instance* sr, uint32_t next_hop_ip, char* interface, uint8_t* ip_datagram, uint8_t* eth_frame, unsigned int ip_datagram_len);
 
+/*Same as sendIPDatagram, for an ip datagram originated by this
+ * router that is not encapsulated in an eth frame yet. The ttl
+ * is not decremented.
+ * @param sr the router instance
+ * @param next_hop_ip the ip addr of the next hop
+ * @param interface the name of the interface to send it out
+ * @param ip_datagram the ip datagram, checksum filled in
+ * @param ip_datagram_len the size of the ip datagram in bytes
+ */
+void sendLocalIPDatagram(struct sr_instance* sr, uint32_t next_hop_ip, char* interface, uint8_t* ip_datagram, unsigned int ip_datagram_len);
+
 /*send an icmp message by first encapsulating it in a ip
  * datagram and pass the ip datagram to the eth layer to
  * be encapsulated in an eth frame and sending the frame
@@ -55,3 +67,47 @@ void ipSendIcmpMessage(struct sr_instance* sr, uint8_t* icmp_message, unsigned i
  * 		of the ip addr assigned to this host
  */
 void ipSendIcmpMessageWithSrcIP(struct sr_instance* sr, uint8_t* icmp_message, unsigned int icmp_msg_len, uint32_t dest_ip, uint32_t src_ip);
+
+/*send a udp segment carrying the payload by encapsulating it in
+ * an ip datagram routed like any other datagram this router
+ * originates
+ * @param sr the router instance
+ * @param src_ip the source ip addr, which should be one
+ * 		of the ip addr assigned to this host
+ * @param dest_ip the ip addr of the host the segment is sent to
+ * @param src_port the source port in host byte order
+ * @param dest_port the destination port in host byte order
+ * @param ttl the ttl the ip datagram goes out with
+ * @param payload the payload of the udp segment
+ * @param payload_len the size of the payload in bytes
+ * @return 1 if there is a route to dest_ip, 0 otherwise
+ */
+int ipSendUdpDatagram(struct sr_instance* sr, uint32_t src_ip, uint32_t dest_ip, uint16_t src_port, uint16_t dest_port, uint8_t ttl, uint8_t* payload, unsigned int payload_len);
+
+/*Send an ip datagram originated by this router that must be
+ * stamped right before it goes out. The ttl is not decremented.
+ * If the next hop's mac addr is not known the datagram waits in
+ * the buffer like any other and is stamped when it leaves.
+ * @param sr the router instance
+ * @param ip_datagram the ip datagram
+ * @param ip_datagram_len the size of the ip datagram in bytes
+ * @param before_send called on the datagram right before it is
+ * 		sent, must leave the ip header alone
+ * @return 1 if the datagram was sent or buffered, 0 if there is
+ * 		no route or the next hop is unreachable
+ */
+int ipSendStampedDatagram(struct sr_instance* sr, uint8_t* ip_datagram, unsigned int ip_datagram_len,
+		void (*before_send)(struct sr_instance* sr, uint8_t* ip_datagram, unsigned int len));
+
+/*Set up the header of an ip datagram originated by this router.
+ * The checksum is left for the sender to compute.
+ *@param ip_hdr the ip header
+ *@param ip_datagram_total_len the size of the entire ip
+ *		datagram in bytes
+ *@param protocol the protocol of the payload
+ *@param ttl the ttl
+ *@param src_ip the source ip addr, which should be one of
+ *		the ip addr assigned to this router
+ *@param dest_ip the destination ip addr
+ */
+void setupIPHeader(struct ip* ip_hdr, uint16_t ip_datagram_total_len, uint8_t protocol, uint8_t ttl, uint32_t src_ip, uint32_t dest_ip);
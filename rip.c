@@ -0,0 +1,731 @@
+/*
+ * rip.c
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <arpa/inet.h>
+
+#include "rip.h"
+#include "udp.h"
+#include "ip.h"
+#include "Ethernet.h"
+#include "sr_rt.h"
+#include "sr_if.h"
+
+/*Find the rip interface with the name passed in
+ * @return the rip interface, or NULL if rip doesn't run on it
+ */
+static struct rip_iface* findRipIface(struct rip_state* rip, const char* name);
+
+/*Find the route to the subnet passed in
+ * @return the route, or NULL if no route to the subnet exists
+ */
+static struct rip_route* findRipRoute(struct rip_state* rip, uint32_t dest, uint32_t mask);
+
+/*Find the route that installed the routing table entry passed in
+ * @return the route, or NULL if the routing table entry was not
+ * 		installed by rip, i.e. it is a static route
+ */
+static struct rip_route* findRipRouteByFibEntry(struct rip_state* rip, struct sr_rt* fib_entry);
+
+/*Check to see if the routing table has a static route to the
+ * subnet. Static routes take precedence over learned ones.
+ * @return 1 if a static route exists, 0 otherwise
+ */
+static int staticRouteExists(struct sr_instance* sr, uint32_t dest, uint32_t mask);
+
+/*Add a new reachable route to the front of the route list and
+ * install it in the routing table
+ * @return the route just added
+ */
+static struct rip_route* addRipRoute(struct sr_instance* sr, uint32_t dest, uint32_t mask, uint32_t next_hop, const char* iface_name, uint32_t metric, time_t now);
+
+/*Remove a route from the route list and free it. The route must
+ * not be installed in the routing table.
+ */
+static void deleteRipRoute(struct rip_state* rip, struct rip_route* route);
+
+/*Mark the route as unreachable, remove it from the routing table
+ * and start its hold-down and garbage collection timers
+ */
+static void loseRipRoute(struct sr_instance* sr, struct rip_route* route, time_t now);
+
+/*Flag the route as changed so it goes out in the next
+ * triggered update
+ */
+static void markRipRouteChanged(struct rip_state* rip, struct rip_route* route);
+
+/*Update the routing table from one entry of a rip response
+ * @param sr the router instance
+ * @param iface the interface the response was received on
+ * @param src_ip the neighbour that sent the response
+ * @param entry the entry
+ * @param now the current time
+ */
+static void processRipEntry(struct sr_instance* sr, struct sr_if* iface, uint32_t src_ip, struct rip_entry* entry, time_t now);
+
+/*Answer a rip request, to the addr and port it came from
+ * (rfc 2453, 3.9.1)
+ * @param sr the router instance
+ * @param iface the interface the request was received on
+ * @param src_ip the ip addr of the requester
+ * @param src_port the udp port of the requester, host byte order
+ * @param entries the entries of the request, overwritten
+ * @param num_entries the number of entries
+ */
+static void answerRipRequest(struct sr_instance* sr, struct sr_if* iface, uint32_t src_ip, uint16_t src_port, struct rip_entry* entries, unsigned int num_entries);
+
+/*Send a request for the whole routing table of the neighbours
+ * on the interface
+ */
+static void sendRipRequest(struct sr_instance* sr, struct sr_if* iface);
+
+/*Send an update out the interface. Split horizon is applied
+ * unless it goes to a port other than the rip port, i.e. to a
+ * monitoring tool rather than a router.
+ * @param sr the router instance
+ * @param iface the interface
+ * @param changed_only 1 for a triggered update carrying only the
+ * 		routes that changed, 0 for a full update
+ * @param dest_ip where to send it, network byte order, normally
+ * 		the rip multicast addr
+ * @param dest_port the udp port to send it to, host byte order
+ */
+static void sendRipUpdate(struct sr_instance* sr, struct sr_if* iface, int changed_only, uint32_t dest_ip, uint16_t dest_port);
+
+/*Send a rip message out the interface
+ * @param sr the router instance
+ * @param iface the interface
+ * @param command RIP_COMMAND_REQUEST or RIP_COMMAND_RESPONSE
+ * @param entries the entries of the message
+ * @param num_entries the number of entries, at most
+ * 		RIP_MAX_ENTRIES_PER_MSG
+ * @param dest_ip the rip multicast addr, or the addr of a single
+ * 		host in network byte order
+ * @param dest_port the udp port to send it to, host byte order
+ */
+static void sendRipMessage(struct sr_instance* sr, struct sr_if* iface, uint8_t command, struct rip_entry* entries, unsigned int num_entries, uint32_t dest_ip, uint16_t dest_port);
+
+/*Send an update out every rip interface and clear the changed
+ * flag of all routes
+ * @param changed_only 1 for a triggered update, 0 for a full update
+ */
+static void sendRipUpdates(struct sr_instance* sr, int changed_only);
+
+/*Send the pending triggered update, unless one has just been sent*/
+static void sendTriggeredUpdateIfDue(struct sr_instance* sr, time_t now);
+
+/*Fill in a route entry of a rip response*/
+static void setupRipEntry(struct rip_entry* entry, uint32_t dest, uint32_t mask, uint32_t metric);
+
+/*Prints a subnet to stdout in the form a.b.c.d/len*/
+static void printSubnet(uint32_t dest, uint32_t mask);
+
+/*Check to see if a host is on the subnet of an interface
+ * @param iface the interface
+ * @param ip the ip addr of the host, network byte order
+ * @return 1 if it is, or if the interface's mask is not known,
+ * 		0 otherwise
+ */
+static int isNeighbour(struct sr_if* iface, uint32_t ip);
+
+
+void ripConfigure(struct sr_instance* sr, const char* iface_names){
+
+	assert(sr);
+	assert(iface_names);
+
+	if(!sr->rip){
+		sr->rip = (struct rip_state*) malloc(sizeof(struct rip_state));
+		assert(sr->rip);
+		bzero(sr->rip, sizeof(struct rip_state));
+	}
+
+	char* names = strdup(iface_names);
+	assert(names);
+
+	char* name = strtok(names, ",");
+	while(name){
+		if(!findRipIface(sr->rip, name)){
+			struct rip_iface* rip_iface = (struct rip_iface*) malloc(sizeof(struct rip_iface));
+			assert(rip_iface);
+			strncpy(rip_iface->name, name, sr_IFACE_NAMELEN);
+			rip_iface->next = sr->rip->iface_list;
+			sr->rip->iface_list = rip_iface;
+		}
+		name = strtok(NULL, ",");
+	}
+
+	free(names);
+}
+
+void ripStart(struct sr_instance* sr){
+
+	assert(sr);
+
+	struct rip_state* rip = sr->rip;
+	if(!rip || rip->started){
+		return;
+	}
+
+	rip->started = TRUE;
+	time(&(rip->last_periodic_update));
+
+	struct rip_iface* rip_iface = rip->iface_list;
+	while(rip_iface){
+		struct sr_if* iface = sr_get_interface(sr, rip_iface->name);
+		if(iface){
+			printf("rip: running on %s\n", iface->name);
+			sendRipRequest(sr, iface);
+			sendRipUpdate(sr, iface, FALSE, htonl(RIP_MULTICAST_IP), RIP_PORT);
+		}
+		else{
+			fprintf(stderr, "rip: no interface %s, ignoring it\n", rip_iface->name);
+		}
+		rip_iface = rip_iface->next;
+	}
+}
+
+int ripRunsOnInterface(struct sr_instance* sr, struct sr_if* iface){
+	return sr->rip && sr->rip->started && iface && findRipIface(sr->rip, iface->name);
+}
+
+int isRipMulticastMAC(const uint8_t* mac){
+	uint8_t rip_mac[ETHER_ADDR_LEN] = RIP_MULTICAST_MAC;
+	return MACcmp(mac, rip_mac);
+}
+
+void handleRipMessage(struct sr_instance* sr, struct sr_if* iface, uint32_t src_ip, uint16_t src_port, uint8_t* rip_msg, unsigned int rip_msg_len){
+
+	assert(sr);
+	assert(iface);
+	assert(rip_msg);
+
+	if(rip_msg_len < sizeof(struct rip_hdr)){
+		//too short, drop it
+		return;
+	}
+
+	struct rip_hdr* hdr = (struct rip_hdr*)rip_msg;
+
+	if(hdr->version != RIP_VERSION){
+		//only rip v2 is spoken here
+		return;
+	}
+
+	struct sr_if* current_iface = sr->if_list;
+	while(current_iface){
+		if(current_iface->ip == src_ip){
+			//one of our own messages, ignore it
+			return;
+		}
+		current_iface = current_iface->next;
+	}
+
+	unsigned int num_entries = (rip_msg_len - sizeof(struct rip_hdr)) / sizeof(struct rip_entry);
+	struct rip_entry* entries = (struct rip_entry*)(rip_msg + sizeof(struct rip_hdr));
+
+	if(hdr->command == RIP_COMMAND_REQUEST){
+		answerRipRequest(sr, iface, src_ip, src_port, entries, num_entries);
+		return;
+	}
+
+	if((hdr->command != RIP_COMMAND_RESPONSE) || (src_port != RIP_PORT)){
+		//responses must come from the rip port
+		return;
+	}
+
+	if(!isNeighbour(iface, src_ip)){
+		//responses must come from a neighbour on the
+		//interface's subnet
+		return;
+	}
+
+	sr->rip->num_responses_received++;
+
+	time_t now = time(NULL);
+
+	for(unsigned int i = 0; i < num_entries; i++){
+		processRipEntry(sr, iface, src_ip, &(entries[i]), now);
+	}
+
+	//let the neighbours know right away about anything that changed
+	sendTriggeredUpdateIfDue(sr, now);
+}
+
+void ripHandleTimers(struct sr_instance* sr){
+
+	struct rip_state* rip = sr->rip;
+	if(!rip || !rip->started){
+		return;
+	}
+
+	time_t now = time(NULL);
+
+	struct rip_route* route = rip->route_list;
+	while(route){
+		struct rip_route* next_route = route->next;
+
+		if((route->metric < RIP_METRIC_INFINITY)
+				&& (difftime(now, route->last_updated) >= RIP_ROUTE_TIMEOUT)){
+			//the neighbour has gone quiet
+			loseRipRoute(sr, route, now);
+		}
+		else if((route->metric >= RIP_METRIC_INFINITY)
+				&& (difftime(now, route->lost_time) >= RIP_GARBAGE_TIME)){
+			//the neighbours have had time to hear it is gone
+			deleteRipRoute(rip, route);
+		}
+
+		route = next_route;
+	}
+
+	if(difftime(now, rip->last_periodic_update) >= RIP_UPDATE_INTERVAL){
+		//a full update covers any pending triggered update
+		sendRipUpdates(sr, FALSE);
+		rip->last_periodic_update = now;
+		rip->num_updates_sent++;
+	}
+	else{
+		sendTriggeredUpdateIfDue(sr, now);
+	}
+}
+
+static void processRipEntry(struct sr_instance* sr, struct sr_if* iface, uint32_t src_ip, struct rip_entry* entry, time_t now){
+
+	struct rip_state* rip = sr->rip;
+
+	if(ntohs(entry->afi) != RIP_AFI_INET){
+		return;
+	}
+
+	uint32_t metric = ntohl(entry->metric);
+	if((metric < 1) || (metric > RIP_METRIC_INFINITY)){
+		//bogus metric, ignore the entry
+		return;
+	}
+
+	uint32_t mask = entry->mask;
+	uint32_t dest = entry->ip & mask;
+	uint32_t first_octet = ntohl(dest) >> 24;
+	if((first_octet == 127) || (first_octet >= 224)){
+		//loopback, multicast or reserved, can't be routed
+		return;
+	}
+
+	//one more hop to get there through the neighbour
+	metric = (metric + 1 < RIP_METRIC_INFINITY) ? metric + 1 : RIP_METRIC_INFINITY;
+
+	if(staticRouteExists(sr, dest, mask)){
+		return;
+	}
+
+	struct rip_route* route = findRipRoute(rip, dest, mask);
+
+	if(!route){
+		if(metric < RIP_METRIC_INFINITY){
+			route = addRipRoute(sr, dest, mask, src_ip, iface->name, metric, now);
+			markRipRouteChanged(rip, route);
+		}
+		return;
+	}
+
+	int from_next_hop = (route->next_hop == src_ip);
+
+	if(route->metric >= RIP_METRIC_INFINITY){
+
+		if((!from_next_hop) && (difftime(now, route->lost_time) < RIP_HOLDDOWN_TIME)){
+			//held down, only the old next hop can bring it back
+			return;
+		}
+
+		if(metric >= RIP_METRIC_INFINITY){
+			return;
+		}
+
+		route->next_hop = src_ip;
+		strncpy(route->iface_name, iface->name, sr_IFACE_NAMELEN);
+		route->metric = metric;
+		route->last_updated = now;
+
+		struct in_addr dest_addr, gw_addr, mask_addr;
+		dest_addr.s_addr = dest;
+		gw_addr.s_addr = src_ip;
+		mask_addr.s_addr = mask;
+		route->fib_entry = sr_add_rt_entry(sr, dest_addr, gw_addr, mask_addr, route->iface_name);
+		markRipRouteChanged(rip, route);
+
+		rip->last_convergence_time = difftime(now, route->lost_time);
+		rip->num_routes_reconverged++;
+		printf("rip: ");
+		printSubnet(dest, mask);
+		printf(" back through %s after %.0f s\n", iface->name, rip->last_convergence_time);
+		return;
+	}
+
+	if(from_next_hop){
+
+		if(metric >= RIP_METRIC_INFINITY){
+			//the neighbour lost it too
+			loseRipRoute(sr, route, now);
+			return;
+		}
+
+		route->last_updated = now;
+
+		if(metric != route->metric){
+			route->metric = metric;
+			markRipRouteChanged(rip, route);
+		}
+	}
+	else if(metric < route->metric){
+
+		//shorter path through another neighbour, update the
+		//routing table entry in place
+		route->next_hop = src_ip;
+		strncpy(route->iface_name, iface->name, sr_IFACE_NAMELEN);
+		route->metric = metric;
+		route->last_updated = now;
+
+		route->fib_entry->gw.s_addr = src_ip;
+		strncpy(route->fib_entry->interface, iface->name, sr_IFACE_NAMELEN);
+		markRipRouteChanged(rip, route);
+	}
+}
+
+static void loseRipRoute(struct sr_instance* sr, struct rip_route* route, time_t now){
+
+	route->metric = RIP_METRIC_INFINITY;
+	route->lost_time = now;
+
+	if(route->fib_entry){
+		sr_del_rt_entry(sr, route->fib_entry);
+		route->fib_entry = NULL;
+	}
+
+	markRipRouteChanged(sr->rip, route);
+	sr->rip->num_routes_lost++;
+
+	printf("rip: lost ");
+	printSubnet(route->dest, route->mask);
+	printf("\n");
+}
+
+static void markRipRouteChanged(struct rip_state* rip, struct rip_route* route){
+	route->changed = TRUE;
+	rip->triggered_update_pending = TRUE;
+}
+
+static void sendTriggeredUpdateIfDue(struct sr_instance* sr, time_t now){
+
+	struct rip_state* rip = sr->rip;
+
+	if(rip->triggered_update_pending
+			&& (difftime(now, rip->last_triggered_update) >= RIP_TRIGGERED_UPDATE_DELAY)){
+		sendRipUpdates(sr, TRUE);
+		rip->last_triggered_update = now;
+		rip->num_triggered_updates_sent++;
+	}
+}
+
+static void sendRipUpdates(struct sr_instance* sr, int changed_only){
+
+	struct rip_state* rip = sr->rip;
+
+	struct rip_iface* rip_iface = rip->iface_list;
+	while(rip_iface){
+		struct sr_if* iface = sr_get_interface(sr, rip_iface->name);
+		if(iface){
+			sendRipUpdate(sr, iface, changed_only, htonl(RIP_MULTICAST_IP), RIP_PORT);
+		}
+		rip_iface = rip_iface->next;
+	}
+
+	struct rip_route* route = rip->route_list;
+	while(route){
+		route->changed = FALSE;
+		route = route->next;
+	}
+	rip->triggered_update_pending = FALSE;
+}
+
+static void sendRipUpdate(struct sr_instance* sr, struct sr_if* iface, int changed_only, uint32_t dest_ip, uint16_t dest_port){
+
+	struct rip_state* rip = sr->rip;
+	struct rip_entry entries[RIP_MAX_ENTRIES_PER_MSG];
+	unsigned int num_entries = 0;
+
+	//split horizon: don't tell a neighbour about routes
+	//learned from it or through it
+	int split_horizon = (dest_port == RIP_PORT);
+
+	if(!changed_only){
+		//static routes, except the default route, are
+		//advertised as directly reachable
+		struct sr_rt* rt_entry = sr->routing_table;
+		while(rt_entry){
+			if((rt_entry->mask.s_addr != 0)
+					&& (!split_horizon || (strncmp(rt_entry->interface, iface->name, sr_IFACE_NAMELEN) != 0))
+					&& !findRipRouteByFibEntry(rip, rt_entry)){
+				setupRipEntry(&(entries[num_entries++]), rt_entry->dest.s_addr, rt_entry->mask.s_addr, 1);
+				if(num_entries == RIP_MAX_ENTRIES_PER_MSG){
+					sendRipMessage(sr, iface, RIP_COMMAND_RESPONSE, entries, num_entries, dest_ip, dest_port);
+					num_entries = 0;
+				}
+			}
+			rt_entry = rt_entry->next;
+		}
+	}
+
+	struct rip_route* route = rip->route_list;
+	while(route){
+		if((!changed_only || route->changed)
+				&& (!split_horizon || (strncmp(route->iface_name, iface->name, sr_IFACE_NAMELEN) != 0))){
+			setupRipEntry(&(entries[num_entries++]), route->dest, route->mask, route->metric);
+			if(num_entries == RIP_MAX_ENTRIES_PER_MSG){
+				sendRipMessage(sr, iface, RIP_COMMAND_RESPONSE, entries, num_entries, dest_ip, dest_port);
+				num_entries = 0;
+			}
+		}
+		route = route->next;
+	}
+
+	if(num_entries > 0){
+		sendRipMessage(sr, iface, RIP_COMMAND_RESPONSE, entries, num_entries, dest_ip, dest_port);
+	}
+}
+
+static void answerRipRequest(struct sr_instance* sr, struct sr_if* iface, uint32_t src_ip, uint16_t src_port, struct rip_entry* entries, unsigned int num_entries){
+
+	if(num_entries == 0){
+		return;
+	}
+
+	if((num_entries == 1) && (ntohs(entries[0].afi) == 0)
+			&& (ntohl(entries[0].metric) == RIP_METRIC_INFINITY)){
+		//a request for the whole table
+		sendRipUpdate(sr, iface, FALSE, src_ip, src_port);
+		return;
+	}
+
+	//a request for specific routes, fill in the metric of each
+	//and send the entries back as they are
+	for(unsigned int i = 0; i < num_entries; i++){
+		uint32_t mask = entries[i].mask;
+		uint32_t dest = entries[i].ip & mask;
+		uint32_t metric = RIP_METRIC_INFINITY;
+
+		if(staticRouteExists(sr, dest, mask)){
+			metric = 1;
+		}
+		else{
+			struct rip_route* route = findRipRoute(sr->rip, dest, mask);
+			if(route){
+				metric = route->metric;
+			}
+		}
+
+		entries[i].metric = htonl(metric);
+	}
+
+	for(unsigned int i = 0; i < num_entries; i += RIP_MAX_ENTRIES_PER_MSG){
+		unsigned int n = num_entries - i;
+		if(n > RIP_MAX_ENTRIES_PER_MSG){
+			n = RIP_MAX_ENTRIES_PER_MSG;
+		}
+		sendRipMessage(sr, iface, RIP_COMMAND_RESPONSE, entries + i, n, src_ip, src_port);
+	}
+}
+
+static void sendRipRequest(struct sr_instance* sr, struct sr_if* iface){
+
+	//a single entry with address family 0 and an infinite
+	//metric asks for the whole table
+	struct rip_entry entry;
+	bzero(&entry, sizeof(struct rip_entry));
+	entry.metric = htonl(RIP_METRIC_INFINITY);
+
+	sendRipMessage(sr, iface, RIP_COMMAND_REQUEST, &entry, 1, htonl(RIP_MULTICAST_IP), RIP_PORT);
+}
+
+static void sendRipMessage(struct sr_instance* sr, struct sr_if* iface, uint8_t command, struct rip_entry* entries, unsigned int num_entries, uint32_t dest_ip, uint16_t dest_port){
+
+	assert(num_entries <= RIP_MAX_ENTRIES_PER_MSG);
+
+	unsigned int rip_msg_len = sizeof(struct rip_hdr) + num_entries * sizeof(struct rip_entry);
+	uint8_t* rip_msg = (uint8_t*) malloc(rip_msg_len);
+	assert(rip_msg);
+
+	struct rip_hdr* hdr = (struct rip_hdr*)rip_msg;
+	hdr->command = command;
+	hdr->version = RIP_VERSION;
+	hdr->zero = 0;
+	memcpy(rip_msg + sizeof(struct rip_hdr), entries, num_entries * sizeof(struct rip_entry));
+
+	if(dest_ip != htonl(RIP_MULTICAST_IP)){
+		if(isNeighbour(iface, dest_ip)){
+			//an answer to a neighbour goes straight back out the
+			//interface the request came in on, there may be no
+			//route to the neighbour in the routing table
+			uint8_t* ip_datagram = createUdpDatagram(iface->ip, dest_ip, RIP_PORT, dest_port,
+					RIP_UNICAST_IP_TTL, rip_msg, rip_msg_len);
+			unsigned int ip_datagram_len = sizeof(struct ip) + UDP_HDR_LEN + rip_msg_len;
+			sendLocalIPDatagram(sr, dest_ip, iface->name, ip_datagram, ip_datagram_len);
+			free(ip_datagram);
+		}
+		else{
+			//an answer to a monitoring tool further away, routed
+			//like any other datagram
+			ipSendUdpDatagram(sr, iface->ip, dest_ip, RIP_PORT, dest_port, RIP_UNICAST_IP_TTL, rip_msg, rip_msg_len);
+		}
+		free(rip_msg);
+		return;
+	}
+
+	uint8_t* ip_datagram = createUdpDatagram(iface->ip, dest_ip, RIP_PORT, dest_port,
+			RIP_IP_TTL, rip_msg, rip_msg_len);
+	unsigned int ip_datagram_len = sizeof(struct ip) + UDP_HDR_LEN + rip_msg_len;
+
+	//multicast, no arp resolution needed
+	uint8_t rip_mac[ETHER_ADDR_LEN] = RIP_MULTICAST_MAC;
+	ethSendIPDatagram(sr, rip_mac, ip_datagram, iface, ip_datagram_len);
+
+	free(ip_datagram);
+	free(rip_msg);
+}
+
+static void setupRipEntry(struct rip_entry* entry, uint32_t dest, uint32_t mask, uint32_t metric){
+	entry->afi = htons(RIP_AFI_INET);
+	entry->route_tag = 0;
+	entry->ip = dest & mask;
+	entry->mask = mask;
+	entry->next_hop = 0;	//through the sender
+	entry->metric = htonl(metric);
+}
+
+static struct rip_route* addRipRoute(struct sr_instance* sr, uint32_t dest, uint32_t mask, uint32_t next_hop, const char* iface_name, uint32_t metric, time_t now){
+
+	struct rip_route* route = (struct rip_route*) malloc(sizeof(struct rip_route));
+	assert(route);
+
+	route->dest = dest;
+	route->mask = mask;
+	route->next_hop = next_hop;
+	strncpy(route->iface_name, iface_name, sr_IFACE_NAMELEN);
+	route->metric = metric;
+	route->last_updated = now;
+	route->lost_time = 0;
+	route->changed = FALSE;
+
+	struct in_addr dest_addr, gw_addr, mask_addr;
+	dest_addr.s_addr = dest;
+	gw_addr.s_addr = next_hop;
+	mask_addr.s_addr = mask;
+	route->fib_entry = sr_add_rt_entry(sr, dest_addr, gw_addr, mask_addr, route->iface_name);
+
+	struct rip_route* first_route = sr->rip->route_list;
+	if(first_route){
+		first_route->previous = route;
+	}
+	route->next = first_route;
+	route->previous = NULL;
+	sr->rip->route_list = route;
+
+	printf("rip: learned ");
+	printSubnet(dest, mask);
+	printf(" through %s, metric %u\n", iface_name, metric);
+
+	return route;
+}
+
+static void deleteRipRoute(struct rip_state* rip, struct rip_route* route){
+
+	assert(!route->fib_entry);
+
+	struct rip_route* previous_route = route->previous;
+	struct rip_route* next_route = route->next;
+
+	if(previous_route){
+		previous_route->next = next_route;
+	}
+	else{
+		rip->route_list = next_route;
+	}
+
+	if(next_route){
+		next_route->previous = previous_route;
+	}
+
+	free(route);
+}
+
+static struct rip_iface* findRipIface(struct rip_state* rip, const char* name){
+
+	struct rip_iface* rip_iface = rip->iface_list;
+
+	while(rip_iface){
+		if(strncmp(rip_iface->name, name, sr_IFACE_NAMELEN) == 0){
+			return rip_iface;
+		}
+		rip_iface = rip_iface->next;
+	}
+
+	return NULL;
+}
+
+static struct rip_route* findRipRoute(struct rip_state* rip, uint32_t dest, uint32_t mask){
+
+	struct rip_route* route = rip->route_list;
+
+	while(route){
+		if((route->dest == dest) && (route->mask == mask)){
+			return route;
+		}
+		route = route->next;
+	}
+
+	return NULL;
+}
+
+static struct rip_route* findRipRouteByFibEntry(struct rip_state* rip, struct sr_rt* fib_entry){
+
+	struct rip_route* route = rip->route_list;
+
+	while(route){
+		if(route->fib_entry == fib_entry){
+			return route;
+		}
+		route = route->next;
+	}
+
+	return NULL;
+}
+
+static int staticRouteExists(struct sr_instance* sr, uint32_t dest, uint32_t mask){
+
+	struct sr_rt* rt_entry = sr->routing_table;
+
+	while(rt_entry){
+		if((rt_entry->mask.s_addr == mask)
+				&& ((rt_entry->dest.s_addr & mask) == dest)
+				&& !findRipRouteByFibEntry(sr->rip, rt_entry)){
+			return TRUE;
+		}
+		rt_entry = rt_entry->next;
+	}
+
+	return FALSE;
+}
+
+static int isNeighbour(struct sr_if* iface, uint32_t ip){
+	return !iface->mask || ((ip & iface->mask) == (iface->ip & iface->mask));
+}
+
+static void printSubnet(uint32_t dest, uint32_t mask){
+	char dotted_ip[INET_ADDRSTRLEN];
+	inet_ntop(AF_INET, &dest, dotted_ip, INET_ADDRSTRLEN);
+	printf("%s/%d", dotted_ip, __builtin_popcount(mask));
+}
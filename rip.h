@@ -0,0 +1,130 @@
+/*
+ * rip.h
+ */
+
+#ifndef RIP_H
+#define RIP_H
+
+#include <time.h>
+
+#include "sr_router.h"
+
+#define RIP_PORT 520
+#define RIP_VERSION 2
+#define RIP_COMMAND_REQUEST 1
+#define RIP_COMMAND_RESPONSE 2
+#define RIP_AFI_INET 2
+#define RIP_METRIC_INFINITY 16
+#define RIP_MAX_ENTRIES_PER_MSG 25
+#define RIP_IP_TTL 1	//updates only go to the neighbours
+#define RIP_UNICAST_IP_TTL 64	//answers to requests, which may come from afar
+
+//224.0.0.9, in host byte order, and the matching mac addr
+#define RIP_MULTICAST_IP 0xe0000009
+#define RIP_MULTICAST_MAC {0x01, 0x00, 0x5e, 0x00, 0x00, 0x09}
+
+//timers, all measured in seconds
+#define RIP_UPDATE_INTERVAL 30	//between periodic updates
+#define RIP_ROUTE_TIMEOUT 180	//a route not refreshed for this long is lost
+#define RIP_GARBAGE_TIME 120	//a lost route is advertised as unreachable for this long
+#define RIP_HOLDDOWN_TIME 60	//a lost route only comes back from its old next hop for this long
+#define RIP_TRIGGERED_UPDATE_DELAY 1	//min time between triggered updates
+
+struct rip_hdr{
+	uint8_t command;
+	uint8_t version;
+	uint16_t zero;
+} __attribute__ ((packed));
+
+struct rip_entry{
+	uint16_t afi;
+	uint16_t route_tag;
+	uint32_t ip;
+	uint32_t mask;
+	uint32_t next_hop;
+	uint32_t metric;
+} __attribute__ ((packed));
+
+/*A route learned from a neighbour. Routes are kept in a doubly
+ * linked list. A route with a metric below RIP_METRIC_INFINITY
+ * is installed in the routing table through fib_entry.
+ */
+struct rip_route{
+	uint32_t dest;	//network byte order, like the rest of the addrs
+	uint32_t mask;
+	uint32_t next_hop;
+	char iface_name[sr_IFACE_NAMELEN];	//where it was learned
+	uint32_t metric;
+	time_t last_updated;	//when the route was last heard, for the timeout
+	time_t lost_time;	//when the metric became RIP_METRIC_INFINITY
+	int changed;	//needs to go out in the next triggered update
+	struct sr_rt* fib_entry;	//NULL while the route is unreachable
+	struct rip_route* previous;
+	struct rip_route* next;
+};
+
+/*An interface rip is running on*/
+struct rip_iface{
+	char name[sr_IFACE_NAMELEN];
+	struct rip_iface* next;
+};
+
+/*The state of the rip speaker of a router*/
+struct rip_state{
+	struct rip_iface* iface_list;
+	struct rip_route* route_list;
+	int started;	//interfaces are known and rip is running
+	time_t last_periodic_update;
+	time_t last_triggered_update;
+	int triggered_update_pending;
+	long num_updates_sent;
+	long num_triggered_updates_sent;
+	long num_responses_received;
+	long num_routes_lost;
+	long num_routes_reconverged;
+	double last_convergence_time;	//seconds from losing a route to learning a new one
+};
+
+/*Turn rip on for the interfaces named. Called before the
+ * interfaces are known, rip starts when ripStart is called.
+ * @param sr the router instance
+ * @param iface_names a comma separated list of interface names
+ */
+void ripConfigure(struct sr_instance* sr, const char* iface_names);
+
+/*Start the rip speaker, once the interfaces are known. Sends a
+ * request and an update out every rip interface.
+ * @param sr the router instance
+ */
+void ripStart(struct sr_instance* sr);
+
+/*Check to see if rip is running on the interface
+ * @param sr the router instance
+ * @param iface the interface
+ * @return 1 if rip runs on the interface, 0 otherwise
+ */
+int ripRunsOnInterface(struct sr_instance* sr, struct sr_if* iface);
+
+/*Check to see if the mac addr is the rip multicast mac addr
+ * @return 1 if it is, 0 otherwise
+ */
+int isRipMulticastMAC(const uint8_t* mac);
+
+/*Handle a rip message received
+ * @param sr the router instance
+ * @param iface the interface the message was received on
+ * @param src_ip the ip addr of the neighbour that sent it
+ * @param src_port the udp port it was sent from, host byte order
+ * @param rip_msg the rip message
+ * @param rip_msg_len the size of the rip message in bytes
+ */
+void handleRipMessage(struct sr_instance* sr, struct sr_if* iface, uint32_t src_ip, uint16_t src_port, uint8_t* rip_msg, unsigned int rip_msg_len);
+
+/*Run the rip timers: time out routes, garbage collect lost routes
+ * and send periodic and pending triggered updates. Called from
+ * the event loop about once a second.
+ * @param sr the router instance
+ */
+void ripHandleTimers(struct sr_instance* sr);
+
+#endif /* RIP_H */
@@ -42,6 +42,7 @@ struct sr_if
     char name[sr_IFACE_NAMELEN];
     unsigned char addr[6];
     uint32_t ip;
+    uint32_t mask;	/*netmask of the subnet, 0 if unknown*/
     uint32_t speed;
     struct ip_eth_arp_tbl_entry* ip_eth_arp_tbl;	/*the arp table associated to this interface instance*/
     struct arp_request_tracker* arp_request_tracker_list;	/*the list of arp request trackers associated to this interface instance*/
@@ -53,6 +54,7 @@ struct sr_if* sr_get_interface(struct sr_instance* sr, const char* name);
 void sr_add_interface(struct sr_instance*, const char*);
 void sr_set_ether_addr(struct sr_instance*, const unsigned char*);
 void sr_set_ether_ip(struct sr_instance*, uint32_t ip_nbo);
+void sr_set_ether_mask(struct sr_instance*, uint32_t mask_nbo);
 void sr_print_if_list(struct sr_instance*);
 void sr_print_if(struct sr_if*);
 
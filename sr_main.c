@@ -32,6 +32,12 @@
 #include "sr_dumper.h"
 #include "sr_router.h"
 #include "sr_rt.h"
+#include "LPMTable.h"
+#include "test.h"
+#include "rip.h"
+#include "Bridge.h"
+#include "watchdog.h"
+#include "twamp.h"
 
 extern char* optarg;
 
@@ -67,11 +73,15 @@ int main(int argc, char **argv)
     unsigned int port = DEFAULT_PORT;
     unsigned int topo = DEFAULT_TOPO;
     char *logfile = 0;
+    char *rip_ifaces = 0;
+    char *bridge_ifaces = 0;
+    long watchdog_threshold_us = 0;
+    int twamp_port = -1;
     struct sr_instance sr;
 
     printf("Using %s\n", VERSION_INFO);
 
-    while ((c = getopt(argc, argv, "ha:s:v:p:u:t:r:l:T:")) != EOF)
+    while ((c = getopt(argc, argv, "hBa:s:v:p:u:t:r:l:T:R:b:w:e:")) != EOF)
     {
         switch (c)
         {
@@ -79,6 +89,10 @@ int main(int argc, char **argv)
                 usage(argv[0]);
                 exit(0);
                 break;
+            case 'B':
+                testBenchmarkLookup();
+                exit(0);
+                break;
             case 'p':
                 port = atoi((char *) optarg);
                 break;
@@ -106,12 +120,35 @@ int main(int argc, char **argv)
             case 'T':
                 template = optarg;
                 break;
+            case 'R':
+                rip_ifaces = optarg;
+                break;
+            case 'b':
+                bridge_ifaces = optarg;
+                break;
+            case 'w':
+                watchdog_threshold_us = atol((char *) optarg);
+                break;
+            case 'e':
+                twamp_port = atoi((char *) optarg);
+                break;
         } /* switch */
     } /* -- while -- */
 
     /* -- zero out sr instance -- */
     sr_init_instance(&sr);
 
+    if(watchdog_threshold_us > 0)
+    { watchdogConfigure(&sr, watchdog_threshold_us); }
+    if(twamp_port >= 0)
+    { twampConfigure(&sr, twamp_port); }
+
+    /* -- rip and the bridge start once the interfaces are known -- */
+    if(rip_ifaces)
+    { ripConfigure(&sr, rip_ifaces); }
+    if(bridge_ifaces)
+    { bridgeConfigure(&sr, bridge_ifaces); }
+
     /* -- set up routing table from file -- */
     if(template == NULL) {
         sr.template[0] = '\0';
@@ -178,10 +215,14 @@ int main(int argc, char **argv)
 static void usage(char* argv0)
 {
     printf("Simple Router Client\n");
-    printf("Format: %s [-h] [-v host] [-s server] [-p port] \n",argv0);
+    printf("Format: %s [-h] [-B] [-v host] [-s server] [-p port] \n",argv0);
     printf("           [-T template_name] [-u username] [-a auth_key_filename]\n");
     printf("           [-t topo id] [-r routing table] \n");
-    printf("           [-l log file] \n");
+    printf("           [-l log file] [-R rip interfaces, e.g. eth1,eth2] \n");
+    printf("           [-b bridged interfaces, e.g. eth1,eth2] \n");
+    printf("           [-w watchdog stall threshold in usec] \n");
+    printf("           [-e twamp-light reflector port, 0 for %d] \n", TWAMP_DEFAULT_PORT);
+    printf("   -B benchmarks routing table lookups and exits\n");
     printf("   defaults server=%s port=%d host=%s  \n",
             DEFAULT_SERVER, DEFAULT_PORT, DEFAULT_HOST );
 } /* -- usage -- */
@@ -228,6 +269,14 @@ static void sr_destroy_instance(struct sr_instance* sr)
         sr_dump_close(sr->logfile);
     }
 
+    destroyLPMTable(sr->lpm_table);
+
+    if(sr->watchdog)
+    { free(sr->watchdog); }
+
+    if(sr->twamp)
+    { free(sr->twamp); }
+
     /*
     fprintf(stderr,"sr_destroy_instance leaking memory\n");
     */
@@ -251,7 +300,12 @@ static void sr_init_instance(struct sr_instance* sr)
     sr->topo_id = 0;
     sr->if_list = 0;
     sr->routing_table = 0;
+    sr->lpm_table = 0;
     sr->logfile = 0;
+    sr->rip = 0;
+    sr->bridge = 0;
+    sr->watchdog = 0;
+    sr->twamp = 0;
 } /* -- sr_init_instance -- */
 
 /*-----------------------------------------------------------------------------
@@ -130,6 +130,16 @@ struct icmphdr
 		uint8_t icmp_code;		//code
 		uint16_t icmp_checksum;		//icmp header checksum
 } __attribute__ ((packed)) ;
+#ifndef IPPROTO_UDP
+#define IPPROTO_UDP             0x0011  /* UDP protocol */
+#endif
+struct sr_udphdr
+{
+    uint16_t uh_sport;                  /* source port */
+    uint16_t uh_dport;                  /* destination port */
+    uint16_t uh_ulen;                   /* udp length, header included */
+    uint16_t uh_sum;                    /* udp checksum, 0 if unused */
+} __attribute__ ((packed)) ;
 #ifndef ETHERTYPE_IP
 #define ETHERTYPE_IP            0x0800  /* IP protocol */
 #endif
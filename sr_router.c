@@ -23,6 +23,10 @@
 #include "sr_rt.h"
 #include "sr_protocol.h"
 #include "Ethernet.h"
+#include "LPMTable.h"
+#include "rip.h"
+#include "Bridge.h"
+#include "watchdog.h"
 #include "test.h"
 
 /*--------------------------------------------------------------------- 
@@ -51,6 +55,12 @@ void sr_init(struct sr_instance* sr)
     sr->num_ip_datagrams_sent = 0;
     sr->num_icmp_messages_created = 0;
 
+    /* the routing table is searched by brute force */
+    destroyLPMTable(sr->lpm_table);
+    sr->lpm_table = createLPMTable(sr->routing_table);
+
+    time(&(sr->last_timer_run));
+
 } /* -- sr_init -- */
 
 
@@ -65,6 +75,10 @@ void initInterfaces(struct sr_instance* sr){
 	   	iface = iface->next;
 	}
 
+	//interfaces are known now, the bridge and rip can get going
+	bridgeStart(sr);
+	ripStart(sr);
+
 	//testSendIcmpMsg(sr);
 }
 
@@ -99,3 +113,30 @@ void sr_handlepacket(struct sr_instance* sr,
 
 		//testmethod(sr, packet, len, interface); //for debug, learning purposes
 }
+
+/*---------------------------------------------------------------------
+ * Method: sr_handle_timers(struct sr_instance* sr)
+ * Scope:  Global
+ *
+ * Called from the event loop whenever it wakes up, at least once every
+ * SR_TIMER_INTERVAL seconds.  Runs the timers of the routing subsystem
+ * if they haven't run in the last SR_TIMER_INTERVAL seconds.
+ *
+ *---------------------------------------------------------------------*/
+
+void sr_handle_timers(struct sr_instance* sr)
+{
+    /* REQUIRES */
+    assert(sr);
+
+    time_t now = time(NULL);
+    if(difftime(now, sr->last_timer_run) < SR_TIMER_INTERVAL)
+    { return; }
+
+    sr->last_timer_run = now;
+
+    WATCHDOG_STAGE(sr, WD_STAGE_TIMERS);
+
+    bridgeHandleTimers(sr);
+    ripHandleTimers(sr);
+} /* -- sr_handle_timers -- */
@@ -12,6 +12,7 @@
 #include <netinet/in.h>
 #include <sys/time.h>
 #include <stdio.h>
+#include <time.h>
 
 #include "sr_if.h"
 #include "sr_rt.h"
@@ -33,6 +34,7 @@
 
 #define INIT_TTL 255
 #define PACKET_DUMP_SIZE 1024
+#define SR_TIMER_INTERVAL 1 /* seconds between runs of the timers */
 
 /* forward declare */
 struct sr_if;
@@ -56,7 +58,14 @@ struct sr_instance
     struct sockaddr_in sr_addr; /* address to server */
     struct sr_if* if_list; /* list of interfaces */
     struct sr_rt* routing_table; /* routing table */
+    struct lpm_table* lpm_table; /* packed copy of a small routing table, NULL if too large */
     FILE* logfile;
+    struct rip_state* rip; /* rip speaker, NULL if rip is off */
+    struct bridge* bridge; /* bridge, NULL if nothing is bridged */
+    struct watchdog* watchdog; /* stall watchdog, NULL if it is off */
+    struct twamp_reflector* twamp; /* twamp-light reflector, NULL if it is off */
+    time_t last_timer_run; /* when the timers last ran */
+    struct timespec packet_rx_time; /* when the packet being handled was read from the server */
     struct datagram_buff* datagram_buff_list; /*the list of ip datagram buffers*/
     int num_datagrams_buffed;	/*the number of ip datagrams buffered*/
     int num_of_datagram_buffers;	/*the number of ip datagram buffers currently exist*/
@@ -79,6 +88,7 @@ int sr_read_from_server(struct sr_instance* );
 /* -- sr_router.c -- */
 void sr_init(struct sr_instance* );
 void sr_handlepacket(struct sr_instance* , uint8_t * , unsigned int , char* );
+void sr_handle_timers(struct sr_instance* );
 
 /* -- sr_if.c -- */
 void sr_add_interface(struct sr_instance* , const char* );
@@ -21,6 +21,7 @@
 
 #include "sr_rt.h"
 #include "sr_router.h"
+#include "LPMTable.h"
 
 /*--------------------------------------------------------------------- 
  * Method:
@@ -80,49 +81,100 @@ int sr_load_rt(struct sr_instance* sr,const char* filename)
 } /* -- sr_load_rt -- */
 
 /*--------------------------------------------------------------------- 
- * Method:
+ * Method: sr_add_rt_entry(..)
+ *
+ * Append an entry to the routing table and return it.  The packed copy
+ * of the table used for lookups, if there is one, is updated in place.
  *
  *---------------------------------------------------------------------*/
 
-void sr_add_rt_entry(struct sr_instance* sr, struct in_addr dest,
+struct sr_rt* sr_add_rt_entry(struct sr_instance* sr, struct in_addr dest,
         struct in_addr gw, struct in_addr mask,char* if_name)
 {
     struct sr_rt* rt_walker = 0;
+    struct sr_rt* new_entry = 0;
 
     /* -- REQUIRES -- */
     assert(if_name);
     assert(sr);
 
+    new_entry = (struct sr_rt*)malloc(sizeof(struct sr_rt));
+    assert(new_entry);
+    new_entry->next = 0;
+    new_entry->dest = dest;
+    new_entry->gw   = gw;
+    new_entry->mask = mask;
+    strncpy(new_entry->interface,if_name,sr_IFACE_NAMELEN);
+
     /* -- empty list special case -- */
     if(sr->routing_table == 0)
     {
-        sr->routing_table = (struct sr_rt*)malloc(sizeof(struct sr_rt));
-        assert(sr->routing_table);
-        sr->routing_table->next = 0;
-        sr->routing_table->dest = dest;
-        sr->routing_table->gw   = gw;
-        sr->routing_table->mask = mask;
-        strncpy(sr->routing_table->interface,if_name,sr_IFACE_NAMELEN);
+        sr->routing_table = new_entry;
+    }
+    else
+    {
+        /* -- find the end of the list -- */
+        rt_walker = sr->routing_table;
+        while(rt_walker->next)
+        {rt_walker = rt_walker->next; }
 
-        return;
+        rt_walker->next = new_entry;
     }
 
-    /* -- find the end of the list -- */
-    rt_walker = sr->routing_table;
-    while(rt_walker->next)
-    {rt_walker = rt_walker->next; }
+    /* -- more routes than the packed table can index, walk the list -- */
+    if(sr->lpm_table && !addLPMTableEntry(sr->lpm_table, new_entry))
+    {
+        destroyLPMTable(sr->lpm_table);
+        sr->lpm_table = 0;
+    }
 
-    rt_walker->next = (struct sr_rt*)malloc(sizeof(struct sr_rt));
-    assert(rt_walker->next);
-    rt_walker = rt_walker->next;
+    return new_entry;
+} /* -- sr_add_entry -- */
 
-    rt_walker->next = 0;
-    rt_walker->dest = dest;
-    rt_walker->gw   = gw;
-    rt_walker->mask = mask;
-    strncpy(rt_walker->interface,if_name,sr_IFACE_NAMELEN);
+/*--------------------------------------------------------------------- 
+ * Method: sr_del_rt_entry(..)
+ *
+ * Remove an entry from the routing table and free it.  The packed copy
+ * of the table used for lookups is updated in place, or rebuilt if the
+ * table has become small enough to be packed again.
+ *
+ *---------------------------------------------------------------------*/
 
-} /* -- sr_add_entry -- */
+void sr_del_rt_entry(struct sr_instance* sr, struct sr_rt* entry)
+{
+    struct sr_rt* rt_walker = 0;
+
+    /* -- REQUIRES -- */
+    assert(sr);
+    assert(entry);
+
+    if(sr->routing_table == entry)
+    {
+        sr->routing_table = entry->next;
+    }
+    else
+    {
+        rt_walker = sr->routing_table;
+        while(rt_walker && rt_walker->next != entry)
+        {rt_walker = rt_walker->next; }
+
+        if(rt_walker == 0)
+        { return; } /* -- not in the table -- */
+
+        rt_walker->next = entry->next;
+    }
+
+    if(sr->lpm_table)
+    {
+        removeLPMTableEntry(sr->lpm_table, entry);
+    }
+    else
+    {
+        sr->lpm_table = createLPMTable(sr->routing_table);
+    }
+
+    free(entry);
+} /* -- sr_del_rt_entry -- */
 
 /*--------------------------------------------------------------------- 
  * Method:
@@ -38,8 +38,9 @@ struct sr_rt
 
 
 int sr_load_rt(struct sr_instance*,const char*);
-void sr_add_rt_entry(struct sr_instance*, struct in_addr,struct in_addr,
+struct sr_rt* sr_add_rt_entry(struct sr_instance*, struct in_addr,struct in_addr,
                   struct in_addr,char*);
+void sr_del_rt_entry(struct sr_instance*, struct sr_rt*);
 void sr_print_routing_table(struct sr_instance* sr);
 void sr_print_routing_entry(struct sr_rt* entry);
 
@@ -35,11 +35,14 @@
 #include <netinet/in.h>
 #include <arpa/inet.h>
 #include <sys/time.h>
+#include <sys/select.h>
 
 #include "sr_dumper.h"
 #include "sr_router.h"
 #include "sr_if.h"
 #include "sr_protocol.h"
+#include "Bridge.h"
+#include "watchdog.h"
 
 #include "sha1.h"
 #include "vnscommand.h"
@@ -198,6 +201,7 @@ int sr_handle_hwinfo(struct sr_instance* sr, c_hwinfo* hwinfo)
             case HWMASK:
                 /* Debug("Mask: %s\n",inet_ntoa(
                             *((struct in_addr*)(hwinfo->mHWInfo[i].value)))); */
+                sr_set_ether_mask(sr,*((uint32_t*)hwinfo->mHWInfo[i].value));
                 break;
             case HWETHIP:
                 /*Debug("IP: %s\n",inet_ntoa(
@@ -319,7 +323,42 @@ int sr_handle_auth_status(struct sr_instance* sr, c_auth_status* status) {
 
 int sr_read_from_server(struct sr_instance* sr /* borrowed */)
 {
-    return sr_read_from_server_expect(sr, 0);
+    fd_set readfds;
+    struct timeval timeout;
+    int ret = 0;
+
+    /* REQUIRES */
+    assert(sr);
+
+    /* -- wait for the next command, waking up to run the timers -- */
+    do
+    {
+        FD_ZERO(&readfds);
+        FD_SET(sr->sockfd, &readfds);
+        timeout.tv_sec  = SR_TIMER_INTERVAL;
+        timeout.tv_usec = 0;
+
+        if((ret = select(sr->sockfd + 1, &readfds, 0, 0, &timeout)) == -1)
+        {
+            if ( errno != EINTR )
+            {
+                perror("select(..):sr_client.c::sr_read_from_server");
+                return -1;
+            }
+        }
+
+        watchdogIterationBegin(sr);
+        sr_handle_timers(sr);
+
+        if ( ret <= 0 )
+        { watchdogIterationEnd(sr); }
+    } while ( ret <= 0 );
+
+    WATCHDOG_STAGE(sr, WD_STAGE_READ);
+    ret = sr_read_from_server_expect(sr, 0);
+    watchdogIterationEnd(sr);
+
+    return ret;
 }
 
 int sr_read_from_server_expect(struct sr_instance* sr /* borrowed */, int expected_cmd)
@@ -397,6 +436,9 @@ int sr_read_from_server_expect(struct sr_instance* sr /* borrowed */, int expect
         } while (errno == EINTR); /* be mindful of signals */
     }
 
+    /* -- note the arrival time before logging or handling it -- */
+    clock_gettime(CLOCK_REALTIME, &(sr->packet_rx_time));
+
     /* My entry for most unreadable line of code - guido */
     /* ... you win - mc                                  */
     command = *(((int *)buf)+1) = ntohl(*(((int *)buf)+1));
@@ -425,7 +467,12 @@ int sr_read_from_server_expect(struct sr_instance* sr /* borrowed */, int expect
                     (char*)(buf + sizeof(c_base))) )
             { break; }
 
+            watchdogPacketBegin(sr, (char*)(buf + sizeof(c_base)),
+                    len - sizeof(c_packet_ethernet_header) +
+                    sizeof(struct sr_ethernet_hdr));
+
             /* -- log packet -- */
+            WATCHDOG_STAGE(sr, WD_STAGE_LOG);
             sr_log_packet(sr, buf + sizeof(c_packet_header),
                     ntohl(sr_pkt->mLen) - sizeof(c_packet_header));
 
@@ -436,6 +483,8 @@ int sr_read_from_server_expect(struct sr_instance* sr /* borrowed */, int expect
                     sizeof(struct sr_ethernet_hdr),
                     (char*)(buf + sizeof(c_base)));
 
+            watchdogPacketEnd(sr);
+
             break;
 
             /* -------------        VNSCLOSE      -------------------- */
@@ -527,6 +576,10 @@ sr_ether_addrs_match_interface( struct sr_instance* sr, /* borrowed */
         return 0;
     }
 
+    /* -- bridge ports pass on frames from other hosts as they are -- */
+    if ( isBridgePort(sr, iface) )
+    { return 1; }
+
     if ( memcmp( ether_hdr->ether_shost, iface->addr, ETHER_ADDR_LEN) != 0 )
     {
         fprintf( stderr, "** Error, source address does not match interface\n");
@@ -572,6 +625,8 @@ int sr_send_packet(struct sr_instance* sr /* borrowed */,
         return -1;
     }
 
+    int prev_stage = WATCHDOG_ENTER_STAGE(sr, WD_STAGE_SEND);
+
     /* Create packet */
     sr_pkt = (c_packet_header *)malloc(len +
             sizeof(c_packet_header));
@@ -583,12 +638,15 @@ int sr_send_packet(struct sr_instance* sr /* borrowed */,
             buf,len);
 
     /* -- log packet -- */
+    WATCHDOG_STAGE(sr, WD_STAGE_LOG);
     sr_log_packet(sr,buf,len);
+    WATCHDOG_STAGE(sr, WD_STAGE_SEND);
 
     if ( ! sr_ether_addrs_match_interface( sr, buf, iface) )
     {
         fprintf( stderr, "*** Error: problem with ethernet header, check log\n");
         free ( sr_pkt );
+        WATCHDOG_LEAVE_STAGE(sr, prev_stage);
         return -1;
     }
 		//printf("Length of packet sent: %d\n", total_len);
@@ -596,11 +654,13 @@ int sr_send_packet(struct sr_instance* sr /* borrowed */,
     {
         fprintf(stderr, "Error writing packet\n");
         free(sr_pkt);
+        WATCHDOG_LEAVE_STAGE(sr, prev_stage);
         return -1;
     }
 
     free(sr_pkt);
 
+    WATCHDOG_LEAVE_STAGE(sr, prev_stage);
     return 0;
 } /* -- sr_send_packet -- */
 
@@ -651,6 +711,10 @@ int  sr_arp_req_not_for_us(struct sr_instance* sr,
 
     assert(iface);
 
+    /* -- the bridge floods arp requests for hosts on other ports -- */
+    if ( isBridgePort(sr, iface) )
+    { return 0; }
+
     e_hdr = (struct sr_ethernet_hdr*)packet;
     a_hdr = (struct sr_arphdr*)(packet + sizeof(struct sr_ethernet_hdr));
 
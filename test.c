@@ -1,6 +1,8 @@
 #include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 #include <assert.h>
+#include <time.h>
 
 #include "test.h"
 #include "sr_router.h"
@@ -9,6 +11,10 @@
 #include "ip.h"
 #include "icmp.h"
 #include "check.h"
+#include "LPMTable.h"
+
+//number of lookups timed per routing table size
+#define BENCH_NUM_LOOKUPS 1000000
 
 /*--------------------------------------------------------------------- 
  * Method: testmethod for debug and learning purposes
@@ -111,3 +117,163 @@ void testSendIcmpMsg(struct sr_instance* sr){
 		free(icmp_msg);
 	}
 }
+
+/*Build a routing table list of random routes for the benchmark*/
+static struct sr_rt* makeRandomRoutingTable(unsigned int num_entries){
+	struct sr_rt* routing_table = NULL;
+	for(unsigned int i=0; i<num_entries; i++){
+		struct sr_rt* rt_entry = (struct sr_rt*)malloc(sizeof(struct sr_rt));
+		assert(rt_entry);
+		unsigned int plen = (i == 0) ? 0 : 8 + (rand() % 23); //first one is the default route
+		uint32_t mask = (plen == 0) ? 0 : (0xffffffff << (32 - plen));
+		rt_entry->dest.s_addr = htonl(((uint32_t)rand() << 1 ^ (uint32_t)rand()) & mask);
+		rt_entry->mask.s_addr = htonl(mask);
+		rt_entry->gw.s_addr = htonl(i);
+		strncpy(rt_entry->interface, "eth0", sr_IFACE_NAMELEN);
+		rt_entry->next = routing_table;
+		routing_table = rt_entry;
+	}
+	return routing_table;
+}
+
+/*Check that the lpm_table and the list pick the same entry for a
+ * destination, for a routing table with duplicate prefixes that has
+ * routes deleted and added
+ */
+static void checkLookupAfterDeletes(void){
+
+	struct sr_rt* routing_table = makeRandomRoutingTable(64);
+
+	//follow every route with a copy so ties have to be broken
+	for(struct sr_rt* rt_entry = routing_table; rt_entry; rt_entry = rt_entry->next->next){
+		struct sr_rt* copy = (struct sr_rt*)malloc(sizeof(struct sr_rt));
+		assert(copy);
+		*copy = *rt_entry;
+		copy->gw.s_addr = ~rt_entry->gw.s_addr;
+		rt_entry->next = copy;
+	}
+
+	struct lpm_table* tbl = createLPMTable(routing_table);
+
+	//delete every third route the way sr_del_rt_entry does
+	struct sr_rt* prev = NULL;
+	struct sr_rt* rt_entry = routing_table;
+	for(unsigned int i=0; rt_entry; i++){
+		struct sr_rt* next = rt_entry->next;
+		if(i % 3 == 0){
+			removeLPMTableEntry(tbl, rt_entry);
+			if(prev){
+				prev->next = next;
+			}
+			else{
+				routing_table = next;
+			}
+			free(rt_entry);
+		}
+		else{
+			prev = rt_entry;
+		}
+		rt_entry = next;
+	}
+
+	//and append a copy of the first route the way sr_add_rt_entry does
+	struct sr_rt* copy = (struct sr_rt*)malloc(sizeof(struct sr_rt));
+	assert(copy);
+	*copy = *routing_table;
+	copy->next = NULL;
+	prev->next = copy;
+	addLPMTableEntry(tbl, copy);
+
+	for(rt_entry = routing_table; rt_entry; rt_entry = rt_entry->next){
+		uint32_t dest = rt_entry->dest.s_addr | htonl(rand() & 0xff);
+		assert(lookupRoutingTableList(routing_table, dest) == lookupLPMTable(tbl, dest));
+	}
+
+	destroyLPMTable(tbl);
+	while(routing_table){
+		rt_entry = routing_table->next;
+		free(routing_table);
+		routing_table = rt_entry;
+	}
+}
+
+static double elapsedNanoSec(struct timespec* start, struct timespec* end){
+	return (end->tv_sec - start->tv_sec) * 1e9 + (end->tv_nsec - start->tv_nsec);
+}
+
+void testBenchmarkLookup(void){
+	unsigned int sizes[] = {1, 2, 4, 8, 16, 24, 32, 48, 64, 96, 128, 192, 256, 512, 1024};
+	unsigned int num_sizes = sizeof(sizes) / sizeof(sizes[0]);
+
+	uint32_t* dests = (uint32_t*)malloc(BENCH_NUM_LOOKUPS * sizeof(uint32_t));
+	assert(dests);
+
+	srand(1);
+	checkLookupAfterDeletes();
+
+	printf("routes\tlist (ns)\tpacked (ns)\n");
+	unsigned int num_list_faster = 0;
+	unsigned int largest_list_faster = 0;
+	for(unsigned int s=0; s<num_sizes; s++){
+		struct sr_rt* routing_table = makeRandomRoutingTable(sizes[s]);
+		struct lpm_table* tbl = createLPMTable(routing_table);
+
+		//aim half of the lookups at a route so both hits and
+		//misses on the longer prefixes are exercised
+		struct sr_rt* rt_entry = routing_table;
+		for(unsigned int i=0; i<BENCH_NUM_LOOKUPS; i++){
+			if((i & 1) && rt_entry){
+				dests[i] = rt_entry->dest.s_addr | htonl(rand() & 0xff);
+				rt_entry = rt_entry->next ? rt_entry->next : routing_table;
+			}
+			else{
+				dests[i] = (uint32_t)rand() << 1 ^ (uint32_t)rand();
+			}
+			assert(lookupRoutingTableList(routing_table, dests[i]) == lookupLPMTable(tbl, dests[i]));
+		}
+
+		struct timespec start, end;
+		volatile uintptr_t sink = 0; //keeps the lookups from being optimized away
+
+		clock_gettime(CLOCK_MONOTONIC, &start);
+		for(unsigned int i=0; i<BENCH_NUM_LOOKUPS; i++){
+			sink += (uintptr_t)lookupRoutingTableList(routing_table, dests[i]);
+		}
+		clock_gettime(CLOCK_MONOTONIC, &end);
+		double list_ns = elapsedNanoSec(&start, &end) / BENCH_NUM_LOOKUPS;
+
+		clock_gettime(CLOCK_MONOTONIC, &start);
+		for(unsigned int i=0; i<BENCH_NUM_LOOKUPS; i++){
+			sink += (uintptr_t)lookupLPMTable(tbl, dests[i]);
+		}
+		clock_gettime(CLOCK_MONOTONIC, &end);
+		double packed_ns = elapsedNanoSec(&start, &end) / BENCH_NUM_LOOKUPS;
+
+		printf("%u\t%.1f\t\t%.1f\t(%.1fx)\n", sizes[s], list_ns, packed_ns, list_ns / packed_ns);
+
+		if(packed_ns >= list_ns){
+			num_list_faster++;
+			largest_list_faster = sizes[s];
+		}
+
+		destroyLPMTable(tbl);
+		while(routing_table){
+			rt_entry = routing_table->next;
+			free(routing_table);
+			routing_table = rt_entry;
+		}
+	}
+
+	//the packed table is used at every size, this shows
+	//whether that ever costs anything
+	if(num_list_faster){
+		printf("list faster at %u of %u sizes, the largest being %u routes\n",
+				num_list_faster, num_sizes, largest_list_faster);
+	}
+	else{
+		printf("packed table faster at every size tested\n");
+	}
+	printf("packed table is used for up to %d routes\n", LPM_TABLE_MAX_ENTRIES);
+
+	free(dests);
+}
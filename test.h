@@ -6,3 +6,7 @@ void testSendArpRequest(struct sr_instance* sr);
 
 //test sending a ping message
 void testSendIcmpMsg(struct sr_instance* sr);
+
+//time longest prefix match lookups with the routing table list
+//and with the packed lpm table over a range of table sizes
+void testBenchmarkLookup(void);
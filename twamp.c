@@ -0,0 +1,131 @@
+/*
+ * twamp.c
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <time.h>
+
+#include "twamp.h"
+#include "ip.h"
+#include "udp.h"
+
+//seconds between 1900 (ntp epoch) and 1970 (unix epoch)
+#define NTP_UNIX_EPOCH_DIFF 2208988800UL
+
+/*Convert a time read from CLOCK_REALTIME to an ntp timestamp
+ * @param ts the time
+ * @param sec_ptr where to put the seconds, network byte order
+ * @param frac_ptr where to put the fraction of a second,
+ * 		network byte order
+ */
+static void toNtpTimestamp(struct timespec* ts, uint32_t* sec_ptr, uint32_t* frac_ptr);
+
+/*Write the send timestamp into a reply and fill in its udp
+ * checksum. Called right before the reply goes out, which may be
+ * after it waited for arp resolution.
+ * @param sr the router instance
+ * @param ip_datagram the ip datagram carrying the reply
+ * @param ip_datagram_len the size of the ip datagram in bytes
+ */
+static void stampReply(struct sr_instance* sr, uint8_t* ip_datagram, unsigned int ip_datagram_len);
+
+
+void twampConfigure(struct sr_instance* sr, uint16_t port){
+
+	assert(sr);
+
+	if(!sr->twamp){
+		sr->twamp = (struct twamp_reflector*) malloc(sizeof(struct twamp_reflector));
+		assert(sr->twamp);
+		bzero(sr->twamp, sizeof(struct twamp_reflector));
+	}
+
+	sr->twamp->port = port ? port : TWAMP_DEFAULT_PORT;
+}
+
+int twampReflectsOnPort(struct sr_instance* sr, uint16_t port){
+	return sr->twamp && (sr->twamp->port == port);
+}
+
+void handleTwampTestPacket(struct sr_instance* sr, struct ip* ip_hdr, uint16_t src_port, uint8_t* test_pkt, unsigned int test_pkt_len){
+
+	assert(sr);
+	assert(ip_hdr);
+	assert(test_pkt);
+
+	//the packet was received when it was read from the server,
+	//logging and the layers below took time since
+	uint32_t receive_sec, receive_frac;
+	toNtpTimestamp(&(sr->packet_rx_time), &receive_sec, &receive_frac);
+
+	struct twamp_reflector* twamp = sr->twamp;
+
+	if(test_pkt_len < TWAMP_SENDER_PKT_LEN){
+		twamp->num_malformed++;
+		return;
+	}
+
+	//the reply is as big as the test packet, so the sender
+	//controls the size in both directions
+	unsigned int reply_len = (test_pkt_len > TWAMP_REFLECTOR_PKT_LEN) ? test_pkt_len : TWAMP_REFLECTOR_PKT_LEN;
+	uint8_t* reply = (uint8_t*) malloc(reply_len);
+	assert(reply);
+	bzero(reply, reply_len);
+
+	struct twamp_sender_pkt* sender_pkt = (struct twamp_sender_pkt*)test_pkt;
+	struct twamp_reflector_pkt* reflector_pkt = (struct twamp_reflector_pkt*)reply;
+
+	//stateless reflector, the sequence number is the sender's
+	reflector_pkt->seq_num = sender_pkt->seq_num;
+	reflector_pkt->error_estimate = htons(TWAMP_ERROR_ESTIMATE);
+	reflector_pkt->receive_timestamp_sec = receive_sec;
+	reflector_pkt->receive_timestamp_frac = receive_frac;
+	reflector_pkt->sender_seq_num = sender_pkt->seq_num;
+	reflector_pkt->sender_timestamp_sec = sender_pkt->timestamp_sec;
+	reflector_pkt->sender_timestamp_frac = sender_pkt->timestamp_frac;
+	reflector_pkt->sender_error_estimate = sender_pkt->error_estimate;
+	reflector_pkt->sender_ttl = ip_hdr->ip_ttl;
+
+	//reply from the addr the test packet was sent to, with a
+	//ttl of 255 on the wire so the sender can count the hops back.
+	//The send timestamp and the checksum are filled in by
+	//stampReply once the reply is about to go out
+	uint8_t* ip_datagram = createUdpDatagram(ip_hdr->ip_dst.s_addr, ip_hdr->ip_src.s_addr, twamp->port, src_port,
+			TWAMP_IP_TTL, reply, reply_len);
+	unsigned int ip_datagram_len = sizeof(struct ip) + UDP_HDR_LEN + reply_len;
+
+	if(!ipSendStampedDatagram(sr, ip_datagram, ip_datagram_len, stampReply)){
+		twamp->num_unroutable++;
+	}
+
+	free(ip_datagram);
+	free(reply);
+}
+
+static void stampReply(struct sr_instance* sr, uint8_t* ip_datagram, unsigned int ip_datagram_len){
+
+	struct ip* ip_hdr = (struct ip*)ip_datagram;
+	uint8_t* udp_segment = ip_datagram + sizeof(struct ip);
+	unsigned int udp_len = ip_datagram_len - sizeof(struct ip);
+	struct twamp_reflector_pkt* reflector_pkt = (struct twamp_reflector_pkt*)(udp_segment + UDP_HDR_LEN);
+
+	struct timespec now;
+	clock_gettime(CLOCK_REALTIME, &now);
+	uint32_t send_sec, send_frac;
+	toNtpTimestamp(&now, &send_sec, &send_frac);
+	reflector_pkt->timestamp_sec = send_sec;
+	reflector_pkt->timestamp_frac = send_frac;
+
+	((struct sr_udphdr*)udp_segment)->uh_sum = udpChecksum(ip_hdr->ip_src.s_addr, ip_hdr->ip_dst.s_addr, udp_segment, udp_len);
+
+	if(sr->twamp){
+		sr->twamp->num_reflected++;
+	}
+}
+
+static void toNtpTimestamp(struct timespec* ts, uint32_t* sec_ptr, uint32_t* frac_ptr){
+	*sec_ptr = htonl((uint32_t)(ts->tv_sec + NTP_UNIX_EPOCH_DIFF));
+	*frac_ptr = htonl((uint32_t)(((uint64_t)ts->tv_nsec << 32) / 1000000000));
+}
@@ -0,0 +1,94 @@
+/*
+ * twamp.h
+ */
+
+#ifndef TWAMP_H
+#define TWAMP_H
+
+#include <stdint.h>
+
+#include "sr_router.h"
+
+//the well known twamp test port, used by the reflector unless
+//another one is given
+#define TWAMP_DEFAULT_PORT 862
+
+//the ttl of the test packets reflected, as it goes out on
+//the wire (rfc 5357, 4.2.1)
+#define TWAMP_IP_TTL 255
+
+//size of the unauthenticated test packet sent to the reflector,
+//padding not included
+#define TWAMP_SENDER_PKT_LEN 14
+
+//size of the unauthenticated test packet reflected back,
+//padding not included
+#define TWAMP_REFLECTOR_PKT_LEN 41
+
+//error estimate of the timestamps of this router: the clock is
+//not known to be synchronized, multiplier 1, scale 0
+#define TWAMP_ERROR_ESTIMATE 0x0001
+
+/*The test packet of a session sender (rfc 5357, 4.1.2)*/
+struct twamp_sender_pkt{
+	uint32_t seq_num;
+	uint32_t timestamp_sec;	//ntp format
+	uint32_t timestamp_frac;
+	uint16_t error_estimate;
+} __attribute__ ((packed));
+
+/*The test packet reflected back to the session sender
+ * (rfc 5357, 4.2.1)
+ */
+struct twamp_reflector_pkt{
+	uint32_t seq_num;
+	uint32_t timestamp_sec;	//when the reply was sent
+	uint32_t timestamp_frac;
+	uint16_t error_estimate;
+	uint16_t mbz1;
+	uint32_t receive_timestamp_sec;	//when the test packet came in
+	uint32_t receive_timestamp_frac;
+	uint32_t sender_seq_num;
+	uint32_t sender_timestamp_sec;
+	uint32_t sender_timestamp_frac;
+	uint16_t sender_error_estimate;
+	uint16_t mbz2;
+	uint8_t sender_ttl;
+} __attribute__ ((packed));
+
+/*The state of the twamp-light reflector of a router*/
+struct twamp_reflector{
+	uint16_t port;	//host byte order
+	long num_reflected;	//replies sent, buffered ones once they go out
+	long num_malformed;	//too short to be a test packet
+	long num_unroutable;	//no route back to the sender, or the next
+				//hop doesn't answer arp
+};
+
+/*Turn the twamp-light reflector on
+ * @param sr the router instance
+ * @param port the udp port to listen on in host byte order,
+ * 		0 for TWAMP_DEFAULT_PORT
+ */
+void twampConfigure(struct sr_instance* sr, uint16_t port);
+
+/*Check to see if the reflector listens on a udp port
+ * @param port the port in host byte order
+ * @return 1 if it does, 0 if not or if the reflector is off
+ */
+int twampReflectsOnPort(struct sr_instance* sr, uint16_t port);
+
+/*Reflect a test packet back to its sender, timestamped with
+ * the time the packet was read from the server and the time
+ * right before the reply is sent. A reply waiting for arp
+ * resolution is stamped when it leaves the buffer.
+ * @param sr the router instance
+ * @param ip_hdr the header of the ip datagram carrying the packet
+ * @param src_port the source port of the test packet in host
+ * 		byte order
+ * @param test_pkt the payload of the udp segment
+ * @param test_pkt_len the size of the payload in bytes
+ */
+void handleTwampTestPacket(struct sr_instance* sr, struct ip* ip_hdr, uint16_t src_port, uint8_t* test_pkt, unsigned int test_pkt_len);
+
+#endif /* TWAMP_H */
@@ -0,0 +1,157 @@
+/*
+ * udp.c
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+#include "udp.h"
+#include "ip.h"
+#include "rip.h"
+#include "twamp.h"
+#include "sr_protocol.h"
+#include "watchdog.h"
+
+//size of the pseudo header the udp checksum covers
+#define UDP_PSEUDO_HDR_LEN 12
+
+/*Checks the udp header against the ip datagram carrying it
+ * @param ip_hdr the header of the ip datagram
+ * @param udp_segment the udp segment
+ * @param udp_len the number of bytes following the ip header
+ * @return 1 if the length and checksum are correct, 0 otherwise
+ */
+static int udpSegmentValid(struct ip* ip_hdr, uint8_t* udp_segment, unsigned int udp_len);
+
+
+int handleUdpSegment(struct sr_instance* sr, struct sr_if* iface, uint8_t* ip_datagram, unsigned int ip_datagram_len){
+
+	assert(sr);
+	assert(iface);
+	assert(ip_datagram);
+
+	int prev_stage = WATCHDOG_ENTER_STAGE(sr, WD_STAGE_UDP);
+
+	if(ip_datagram_len < sizeof(struct ip) + UDP_HDR_LEN){
+		//too short to hold a udp header
+		WATCHDOG_LEAVE_STAGE(sr, prev_stage);
+		return UDP_SEGMENT_DROPPED;
+	}
+
+	struct ip* ip_hdr = (struct ip*)ip_datagram;
+	uint8_t* udp_segment = ip_datagram + sizeof(struct ip);
+	unsigned int udp_len = ip_datagram_len - sizeof(struct ip);
+
+	if(!udpSegmentValid(ip_hdr, udp_segment, udp_len)){
+		//corrupt, the sender doesn't get told about it
+		WATCHDOG_LEAVE_STAGE(sr, prev_stage);
+		return UDP_SEGMENT_DROPPED;
+	}
+
+	struct sr_udphdr* udp_hdr = (struct sr_udphdr*)udp_segment;
+	uint8_t* payload = udp_segment + UDP_HDR_LEN;
+	unsigned int payload_len = ntohs(udp_hdr->uh_ulen) - UDP_HDR_LEN;
+
+	if(twampReflectsOnPort(sr, ntohs(udp_hdr->uh_dport)) && !IN_MULTICAST(ntohl(ip_hdr->ip_dst.s_addr))){
+		//the reflector port is configurable, so it can't be
+		//one of the cases below. Test packets sent to a multicast
+		//addr are not answered, the reply would come from it
+		handleTwampTestPacket(sr, ip_hdr, ntohs(udp_hdr->uh_sport), payload, payload_len);
+		WATCHDOG_LEAVE_STAGE(sr, prev_stage);
+		return UDP_SEGMENT_HANDLED;
+	}
+
+	switch(ntohs(udp_hdr->uh_dport)){
+		case(RIP_PORT):
+		{
+			if(ripRunsOnInterface(sr, iface)){
+				handleRipMessage(sr, iface, ip_hdr->ip_src.s_addr, ntohs(udp_hdr->uh_sport), payload, payload_len);
+				WATCHDOG_LEAVE_STAGE(sr, prev_stage);
+				return UDP_SEGMENT_HANDLED;
+			}
+			break;
+		}
+		default:
+			break;
+	}
+
+	if(IN_MULTICAST(ntohl(ip_hdr->ip_dst.s_addr))){
+		//no icmp errors about multicast datagrams (rfc 1122)
+		WATCHDOG_LEAVE_STAGE(sr, prev_stage);
+		return UDP_SEGMENT_DROPPED;
+	}
+
+	//nobody is listening on this port
+	WATCHDOG_LEAVE_STAGE(sr, prev_stage);
+	return UDP_PORT_UNREACHABLE;
+}
+
+uint16_t udpChecksum(uint32_t src_ip, uint32_t dest_ip, uint8_t* udp_segment, unsigned int udp_len){
+
+	//the checksum is computed over the pseudo header followed
+	//by the udp segment, padded with a zero byte if needed
+	unsigned int buff_len = UDP_PSEUDO_HDR_LEN + udp_len + 1;
+	uint8_t* buff = (uint8_t*)malloc(buff_len);
+	assert(buff);
+	bzero(buff, buff_len);
+
+	memcpy(buff, &src_ip, 4);
+	memcpy(buff + 4, &dest_ip, 4);
+	buff[9] = IPPROTO_UDP;
+	uint16_t len = htons(udp_len);
+	memcpy(buff + 10, &len, 2);
+
+	memcpy(buff + UDP_PSEUDO_HDR_LEN, udp_segment, udp_len);
+	((struct sr_udphdr*)(buff + UDP_PSEUDO_HDR_LEN))->uh_sum = 0;
+
+	uint16_t checksum = csum((uint16_t*)buff, UDP_PSEUDO_HDR_LEN + udp_len);
+
+	free(buff);
+
+	//a computed checksum of 0 is sent as all ones, 0 means
+	//no checksum
+	return (checksum == 0) ? 0xffff : checksum;
+}
+
+uint8_t* createUdpDatagram(uint32_t src_ip, uint32_t dest_ip, uint16_t src_port, uint16_t dest_port, uint8_t ttl, uint8_t* payload, unsigned int payload_len){
+
+	unsigned int udp_len = UDP_HDR_LEN + payload_len;
+	unsigned int ip_datagram_len = sizeof(struct ip) + udp_len;
+
+	uint8_t* ip_datagram = (uint8_t*)malloc(ip_datagram_len);
+	assert(ip_datagram);
+
+	struct ip* ip_hdr = (struct ip*)ip_datagram;
+	setupIPHeader(ip_hdr, ip_datagram_len, IPPROTO_UDP, ttl, src_ip, dest_ip);
+	ip_hdr->ip_sum = 0;
+	ip_hdr->ip_sum = csum((uint16_t*)ip_datagram, sizeof(struct ip));
+
+	uint8_t* udp_segment = ip_datagram + sizeof(struct ip);
+	struct sr_udphdr* udp_hdr = (struct sr_udphdr*)udp_segment;
+	udp_hdr->uh_sport = htons(src_port);
+	udp_hdr->uh_dport = htons(dest_port);
+	udp_hdr->uh_ulen = htons(udp_len);
+	memcpy(udp_segment + UDP_HDR_LEN, payload, payload_len);
+	udp_hdr->uh_sum = udpChecksum(src_ip, dest_ip, udp_segment, udp_len);
+
+	return ip_datagram;
+}
+
+static int udpSegmentValid(struct ip* ip_hdr, uint8_t* udp_segment, unsigned int udp_len){
+
+	struct sr_udphdr* udp_hdr = (struct sr_udphdr*)udp_segment;
+	unsigned int len = ntohs(udp_hdr->uh_ulen);
+
+	if((len < UDP_HDR_LEN) || (len > udp_len)){
+		//udp length doesn't fit in the ip datagram
+		return FALSE;
+	}
+
+	if(udp_hdr->uh_sum == 0){
+		//sender didn't compute a checksum
+		return TRUE;
+	}
+
+	return udp_hdr->uh_sum == udpChecksum(ip_hdr->ip_src.s_addr, ip_hdr->ip_dst.s_addr, udp_segment, len);
+}
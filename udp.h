@@ -0,0 +1,52 @@
+/*
+ * udp.h
+ */
+
+#ifndef UDP_H
+#define UDP_H
+
+#include "sr_router.h"
+
+#define UDP_HDR_LEN 8
+
+//results of handleUdpSegment
+#define UDP_SEGMENT_HANDLED 0	//a service took the segment
+#define UDP_PORT_UNREACHABLE 1	//nothing listens on the port, send an icmp error
+#define UDP_SEGMENT_DROPPED 2	//malformed, or no icmp error is allowed, drop it silently
+
+/*Hand a udp segment destined for this router to the service
+ * listening on its destination port
+ * @param sr the router instance
+ * @param iface the interface the ip datagram was received on
+ * @param ip_datagram the ip datagram encapsulating the udp segment
+ * @param ip_datagram_len the size of the ip datagram in bytes
+ * @return UDP_SEGMENT_HANDLED, UDP_PORT_UNREACHABLE or
+ * 		UDP_SEGMENT_DROPPED
+ */
+int handleUdpSegment(struct sr_instance* sr, struct sr_if* iface, uint8_t* ip_datagram, unsigned int ip_datagram_len);
+
+/*Calculate the udp checksum, pseudo header included
+ * @param src_ip the source ip addr of the ip datagram
+ * @param dest_ip the destination ip addr of the ip datagram
+ * @param udp_segment the udp segment, its checksum field is
+ * 		treated as 0
+ * @param udp_len the size of the udp segment in bytes
+ * @return the checksum to be put in the udp header
+ */
+uint16_t udpChecksum(uint32_t src_ip, uint32_t dest_ip, uint8_t* udp_segment, unsigned int udp_len);
+
+/*Create an ip datagram encapsulating a udp segment carrying the
+ * payload, with the ip and udp checksums filled in
+ * @param src_ip the source ip addr
+ * @param dest_ip the destination ip addr
+ * @param src_port the source port in host byte order
+ * @param dest_port the destination port in host byte order
+ * @param ttl the ttl of the ip datagram
+ * @param payload the payload
+ * @param payload_len the size of the payload in bytes
+ * @return the ip datagram, to be freed by the caller. Its size is
+ * 		sizeof(struct ip) + UDP_HDR_LEN + payload_len
+ */
+uint8_t* createUdpDatagram(uint32_t src_ip, uint32_t dest_ip, uint16_t src_port, uint16_t dest_port, uint8_t ttl, uint8_t* payload, unsigned int payload_len);
+
+#endif /* UDP_H */
@@ -0,0 +1,324 @@
+/*
+ * watchdog.c
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+#include "watchdog.h"
+#include "Bridge.h"
+#include "rip.h"
+#include "twamp.h"
+
+static const char* stage_names[WD_NUM_STAGES] = {
+	"idle", "timers", "read", "log", "eth", "bridge", "arp",
+	"pending", "ip", "lookup", "icmp", "udp", "send"
+};
+
+/*Read the monotonic clock
+ * @return the time in nanoseconds
+ */
+static uint64_t nowNanoSec(void);
+
+/*Charge the time since the last stage marker to the current stage
+ * @param wd the watchdog
+ * @param now_ns the current time in nanoseconds
+ */
+static void chargeCurrentStage(struct watchdog* wd, uint64_t now_ns);
+
+/*Find the stage that took the most time, given the time spent
+ * in each stage before and after
+ * @param before the time per stage before, NULL for all 0
+ * @param after the time per stage after
+ * @param stage_us_ptr where to put the time spent in the stage
+ * @return the stage
+ */
+static uint8_t findSlowestStage(uint64_t* before, uint64_t* after, uint32_t* stage_us_ptr);
+
+/*Add an entry to the flight recorder, overwriting the oldest one.
+ * An iteration is recorded after the packets handled in it, so the
+ * entry is moved back past the ones that started later to keep the
+ * recorder in order of start time.
+ */
+static void record(struct watchdog* wd, struct wd_record* rec);
+
+/*Report a stall, with a dump unless one was printed recently*/
+static void reportStall(struct sr_instance* sr, struct wd_record* rec);
+
+/*Prints an entry of the flight recorder to stderr*/
+static void printRecord(struct wd_record* rec, uint64_t now_ns);
+
+
+void watchdogConfigure(struct sr_instance* sr, uint32_t threshold_us){
+
+	assert(sr);
+
+	if(!sr->watchdog){
+		sr->watchdog = (struct watchdog*) malloc(sizeof(struct watchdog));
+		assert(sr->watchdog);
+		bzero(sr->watchdog, sizeof(struct watchdog));
+	}
+
+	sr->watchdog->threshold_us = threshold_us;
+	sr->watchdog->current_stage = WD_STAGE_IDLE;
+	sr->watchdog->stage_start_ns = nowNanoSec();
+}
+
+void watchdogMarkStage(struct sr_instance* sr, int stage){
+
+	struct watchdog* wd = sr->watchdog;
+
+	assert((stage >= 0) && (stage < WD_NUM_STAGES));
+
+	chargeCurrentStage(wd, nowNanoSec());
+	wd->current_stage = stage;
+
+	if(stage == WD_STAGE_TIMERS){
+		wd->iteration_ran_timers = TRUE;
+	}
+}
+
+int watchdogEnterStage(struct sr_instance* sr, int stage){
+
+	int prev_stage = sr->watchdog->current_stage;
+	watchdogMarkStage(sr, stage);
+
+	return prev_stage;
+}
+
+void watchdogIterationBegin(struct sr_instance* sr){
+
+	struct watchdog* wd = sr->watchdog;
+	if(!wd){
+		return;
+	}
+
+	uint64_t now_ns = nowNanoSec();
+
+	chargeCurrentStage(wd, now_ns);
+	bzero(wd->stage_ns, sizeof(wd->stage_ns));
+	wd->current_stage = WD_STAGE_READ;
+	wd->iteration_start_ns = now_ns;
+	wd->iteration_stalled = FALSE;
+	wd->iteration_packets = 0;
+	wd->iteration_ran_timers = FALSE;
+}
+
+void watchdogIterationEnd(struct sr_instance* sr){
+
+	struct watchdog* wd = sr->watchdog;
+	if(!wd || !wd->iteration_start_ns){
+		return;
+	}
+
+	uint64_t now_ns = nowNanoSec();
+	chargeCurrentStage(wd, now_ns);
+
+	struct wd_record rec;
+	bzero(&rec, sizeof(struct wd_record));
+	rec.kind = WD_KIND_ITERATION;
+	rec.start_ns = wd->iteration_start_ns;
+	rec.duration_us = (now_ns - wd->iteration_start_ns) / 1000;
+	rec.slowest_stage = findSlowestStage(NULL, wd->stage_ns, &(rec.slowest_stage_us));
+
+	wd->num_iterations++;
+	if(rec.duration_us > wd->max_iteration_us){
+		wd->max_iteration_us = rec.duration_us;
+	}
+
+	wd->iteration_start_ns = 0;
+	wd->current_stage = WD_STAGE_IDLE;
+
+	//a packet has its own entry, only record the iteration
+	//around it if something else happened in it too
+	if((rec.duration_us > wd->threshold_us) || wd->iteration_ran_timers || !wd->iteration_packets){
+		record(wd, &rec);
+	}
+
+	if((rec.duration_us > wd->threshold_us) && !wd->iteration_stalled){
+		reportStall(sr, &rec);
+	}
+}
+
+void watchdogPacketBegin(struct sr_instance* sr, const char* interface, unsigned int len){
+
+	struct watchdog* wd = sr->watchdog;
+	if(!wd){
+		return;
+	}
+
+	uint64_t now_ns = nowNanoSec();
+	chargeCurrentStage(wd, now_ns);
+	memcpy(wd->packet_stage_ns, wd->stage_ns, sizeof(wd->stage_ns));
+
+	bzero(&(wd->packet), sizeof(struct wd_record));
+	wd->packet.kind = WD_KIND_PACKET;
+	wd->iteration_packets++;
+	wd->packet.start_ns = now_ns;
+	wd->packet.len = (len > 0xffff) ? 0xffff : len;
+	strncpy(wd->packet.iface_name, interface, sizeof(wd->packet.iface_name) - 1);
+}
+
+void watchdogPacketEnd(struct sr_instance* sr){
+
+	struct watchdog* wd = sr->watchdog;
+	if(!wd){
+		return;
+	}
+
+	uint64_t now_ns = nowNanoSec();
+	chargeCurrentStage(wd, now_ns);
+
+	struct wd_record* rec = &(wd->packet);
+	rec->duration_us = (now_ns - rec->start_ns) / 1000;
+	rec->slowest_stage = findSlowestStage(wd->packet_stage_ns, wd->stage_ns, &(rec->slowest_stage_us));
+
+	wd->num_packets++;
+	if(rec->duration_us > wd->max_packet_us){
+		wd->max_packet_us = rec->duration_us;
+	}
+
+	record(wd, rec);
+
+	if(rec->duration_us > wd->threshold_us){
+		wd->iteration_stalled = TRUE;
+		reportStall(sr, rec);
+	}
+}
+
+void watchdogDump(struct sr_instance* sr){
+
+	struct watchdog* wd = sr->watchdog;
+	if(!wd){
+		return;
+	}
+
+	uint64_t now_ns = nowNanoSec();
+
+	unsigned int num_entries = (wd->num_records < WD_DUMP_ENTRIES) ? wd->num_records : WD_DUMP_ENTRIES;
+	fprintf(stderr, "watchdog: last %u iterations/packets, oldest first\n", num_entries);
+
+	for(unsigned int i = num_entries; i > 0; i--){
+		unsigned int slot = (wd->recorder_next + WD_RECORDER_SIZE - i) % WD_RECORDER_SIZE;
+		printRecord(&(wd->recorder[slot]), now_ns);
+	}
+
+	fprintf(stderr, "watchdog: %ld iterations (max %u us), %ld packets (max %u us), %ld stalls (%ld not dumped)\n",
+			wd->num_iterations, wd->max_iteration_us, wd->num_packets, wd->max_packet_us,
+			wd->num_stalls, wd->num_stalls_not_dumped);
+	fprintf(stderr, "watchdog: ip received %ld, sent %ld, dropped %ld, icmp created %ld\n",
+			sr->num_ip_datagrams_received, sr->num_ip_datagrams_sent,
+			sr->num_ip_datagrams_dropped, sr->num_icmp_messages_created);
+	fprintf(stderr, "watchdog: %d datagrams buffered in %d buffers, %d arp entries, %d arp requests pending\n",
+			sr->num_datagrams_buffed, sr->num_of_datagram_buffers,
+			sr->num_arp_entries, sr->num_arp_request_trackers);
+
+	if(sr->rip){
+		fprintf(stderr, "watchdog: rip %ld responses received, %ld routes lost, %ld triggered updates\n",
+				sr->rip->num_responses_received, sr->rip->num_routes_lost,
+				sr->rip->num_triggered_updates_sent);
+	}
+
+	if(sr->twamp){
+		fprintf(stderr, "watchdog: twamp %ld reflected, %ld malformed, %ld unroutable\n",
+				sr->twamp->num_reflected, sr->twamp->num_malformed, sr->twamp->num_unroutable);
+	}
+
+	if(sr->bridge){
+		fprintf(stderr, "watchdog: bridge %d macs learned, %.1f floods/s\n",
+				sr->bridge->num_mac_entries, sr->bridge->flood_rate);
+	}
+}
+
+static void reportStall(struct sr_instance* sr, struct wd_record* rec){
+
+	struct watchdog* wd = sr->watchdog;
+	wd->num_stalls++;
+
+	time_t now = time(NULL);
+	if(wd->last_dump_time && (difftime(now, wd->last_dump_time) < WD_DUMP_INTERVAL)){
+		//don't let the dumps cause more stalls
+		wd->num_stalls_not_dumped++;
+		return;
+	}
+	wd->last_dump_time = now;
+
+	if(rec->kind == WD_KIND_PACKET){
+		fprintf(stderr, "watchdog: packet of %u bytes on %s took %u us (threshold %u us), %u us in %s\n",
+				rec->len, rec->iface_name, rec->duration_us, wd->threshold_us,
+				rec->slowest_stage_us, stage_names[rec->slowest_stage]);
+	}
+	else{
+		fprintf(stderr, "watchdog: loop iteration took %u us (threshold %u us), %u us in %s\n",
+				rec->duration_us, wd->threshold_us,
+				rec->slowest_stage_us, stage_names[rec->slowest_stage]);
+	}
+
+	watchdogDump(sr);
+}
+
+static void printRecord(struct wd_record* rec, uint64_t now_ns){
+
+	double age_ms = (now_ns - rec->start_ns) / 1e6;
+
+	if(rec->kind == WD_KIND_PACKET){
+		fprintf(stderr, "  -%9.3f ms  packet    %6u us  %-7s %5u bytes on %s (%u us)\n",
+				age_ms, rec->duration_us, stage_names[rec->slowest_stage],
+				rec->len, rec->iface_name, rec->slowest_stage_us);
+	}
+	else{
+		fprintf(stderr, "  -%9.3f ms  iteration %6u us  %-7s (%u us)\n",
+				age_ms, rec->duration_us, stage_names[rec->slowest_stage],
+				rec->slowest_stage_us);
+	}
+}
+
+static void record(struct watchdog* wd, struct wd_record* rec){
+
+	unsigned int slot = wd->recorder_next;
+	long num_before = (wd->num_records < WD_RECORDER_SIZE) ? wd->num_records : WD_RECORDER_SIZE - 1;
+
+	while(num_before > 0){
+		unsigned int prev_slot = (slot + WD_RECORDER_SIZE - 1) % WD_RECORDER_SIZE;
+		if(wd->recorder[prev_slot].start_ns <= rec->start_ns){
+			break;
+		}
+		wd->recorder[slot] = wd->recorder[prev_slot];
+		slot = prev_slot;
+		num_before--;
+	}
+
+	wd->recorder[slot] = *rec;
+	wd->recorder_next = (wd->recorder_next + 1) % WD_RECORDER_SIZE;
+	wd->num_records++;
+}
+
+static uint8_t findSlowestStage(uint64_t* before, uint64_t* after, uint32_t* stage_us_ptr){
+
+	uint8_t slowest_stage = WD_STAGE_IDLE;
+	uint64_t slowest_ns = 0;
+
+	for(int stage = 0; stage < WD_NUM_STAGES; stage++){
+		uint64_t stage_ns = after[stage] - (before ? before[stage] : 0);
+		if(stage_ns > slowest_ns){
+			slowest_ns = stage_ns;
+			slowest_stage = stage;
+		}
+	}
+
+	*stage_us_ptr = slowest_ns / 1000;
+	return slowest_stage;
+}
+
+static void chargeCurrentStage(struct watchdog* wd, uint64_t now_ns){
+	wd->stage_ns[wd->current_stage] += now_ns - wd->stage_start_ns;
+	wd->stage_start_ns = now_ns;
+}
+
+static uint64_t nowNanoSec(void){
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t) ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
@@ -0,0 +1,135 @@
+/*
+ * watchdog.h
+ */
+
+#ifndef WATCHDOG_H
+#define WATCHDOG_H
+
+#include <stdint.h>
+#include <time.h>
+
+#include "sr_router.h"
+
+//the stages of the router the watchdog charges time to. The
+//time between two stage markers goes to the first one. Work
+//that can be done from inside another stage enters its stage
+//with WATCHDOG_ENTER_STAGE and gives the time after it back
+//with WATCHDOG_LEAVE_STAGE.
+#define WD_STAGE_IDLE 0		//outside of any iteration
+#define WD_STAGE_TIMERS 1	//rip and bridge timers
+#define WD_STAGE_READ 2		//reading a command from the server
+#define WD_STAGE_LOG 3		//writing a packet to the dump file
+#define WD_STAGE_ETH 4		//ethernet demultiplexing
+#define WD_STAGE_BRIDGE 5	//mac learning and bridging
+#define WD_STAGE_ARP 6		//arp packets and resolution
+#define WD_STAGE_PENDING 7	//draining the buffered ip datagrams
+#define WD_STAGE_IP 8		//ip header checks
+#define WD_STAGE_LOOKUP 9	//routing table lookup
+#define WD_STAGE_ICMP 10	//icmp messages
+#define WD_STAGE_UDP 11		//udp services, e.g. rip
+#define WD_STAGE_SEND 12	//writing a packet to the server
+#define WD_NUM_STAGES 13
+
+//number of iterations and packets the flight recorder remembers
+#define WD_RECORDER_SIZE 64
+
+//number of flight recorder entries printed in a dump
+#define WD_DUMP_ENTRIES 16
+
+//min seconds between two dumps, stalls in between are only counted
+#define WD_DUMP_INTERVAL 5
+
+#define WD_KIND_ITERATION 0
+#define WD_KIND_PACKET 1
+
+/*Mark the start of a stage. Cheap enough to leave in the fast
+ * path, and does nothing unless the watchdog is on.
+ */
+#define WATCHDOG_STAGE(sr, stage) \
+	do { if((sr)->watchdog) { watchdogMarkStage((sr), (stage)); } } while(0)
+
+/*Mark the start of a stage entered from another one
+ * @return the stage to give to WATCHDOG_LEAVE_STAGE on
+ * 		every return path
+ */
+#define WATCHDOG_ENTER_STAGE(sr, stage) \
+	((sr)->watchdog ? watchdogEnterStage((sr), (stage)) : WD_STAGE_IDLE)
+
+/*Go back to the stage the current one was entered from*/
+#define WATCHDOG_LEAVE_STAGE(sr, prev_stage) WATCHDOG_STAGE((sr), (prev_stage))
+
+/*An entry of the flight recorder: one loop iteration or
+ * the processing of one packet
+ */
+struct wd_record{
+	uint64_t start_ns;	//monotonic clock
+	uint32_t duration_us;
+	uint32_t slowest_stage_us;	//time spent in slowest_stage
+	uint8_t kind;	//WD_KIND_ITERATION or WD_KIND_PACKET
+	uint8_t slowest_stage;
+	uint16_t len;	//packet size in bytes, 0 for iterations
+	char iface_name[8];	//where the packet came in
+};
+
+/*The state of the watchdog of a router*/
+struct watchdog{
+	uint32_t threshold_us;	//iterations or packets taking longer are stalls
+
+	int current_stage;
+	uint64_t stage_start_ns;
+	uint64_t stage_ns[WD_NUM_STAGES];	//time per stage in the current iteration
+
+	uint64_t iteration_start_ns;	//0 outside of an iteration
+	int iteration_stalled;	//a packet in the iteration was already reported
+	int iteration_packets;	//packets handled in the current iteration
+	int iteration_ran_timers;
+
+	struct wd_record packet;	//the packet being processed
+	uint64_t packet_stage_ns[WD_NUM_STAGES];	//stage_ns when the packet came in
+
+	struct wd_record recorder[WD_RECORDER_SIZE];
+	unsigned int recorder_next;	//the slot the next record goes in
+	long num_records;
+
+	long num_iterations;
+	long num_packets;
+	long num_stalls;
+	long num_stalls_not_dumped;
+	uint32_t max_iteration_us;
+	uint32_t max_packet_us;
+	time_t last_dump_time;
+};
+
+/*Turn the watchdog on
+ * @param sr the router instance
+ * @param threshold_us iterations or packets taking longer than this
+ * 		many microseconds are reported
+ */
+void watchdogConfigure(struct sr_instance* sr, uint32_t threshold_us);
+
+/*Called by WATCHDOG_STAGE, use the macro instead*/
+void watchdogMarkStage(struct sr_instance* sr, int stage);
+
+/*Called by WATCHDOG_ENTER_STAGE, use the macro instead*/
+int watchdogEnterStage(struct sr_instance* sr, int stage);
+
+/*Mark the start and the end of one event loop iteration, i.e. the
+ * work done after the loop wakes up and before it waits again
+ */
+void watchdogIterationBegin(struct sr_instance* sr);
+void watchdogIterationEnd(struct sr_instance* sr);
+
+/*Mark the start and the end of the processing of a packet
+ * @param sr the router instance
+ * @param interface the name of the interface the packet came in on
+ * @param len the size of the packet in bytes
+ */
+void watchdogPacketBegin(struct sr_instance* sr, const char* interface, unsigned int len);
+void watchdogPacketEnd(struct sr_instance* sr);
+
+/*Prints the most recent flight recorder entries and the
+ * router's counters to stderr
+ */
+void watchdogDump(struct sr_instance* sr);
+
+#endif /* WATCHDOG_H */